@@ -0,0 +1,511 @@
+//! End-to-end constrained-decoding simulation harness.
+//!
+//! The criterion benches in `hot_paths.rs` time each FFI call in isolation;
+//! nothing there exercises the full production loop of compile → create
+//! matcher → thousands of fill-bitmask → apply → sample → accept steps with
+//! occasional rollbacks, so cross-cutting regressions (FFI chatter, per-step
+//! allocations, memory growth) stay invisible. This target replays decode
+//! traces — a grammar plus the token sequence a model produced under it —
+//! against a mock argmax sampler and reports, per trace and per phase:
+//! latency percentiles, allocations per step, and peak RSS. Every sampled
+//! token is checked against the trace, so a mask that wrongly rejects a
+//! valid token fails the run; CI can gate on the exit code and diff the
+//! numbers.
+//!
+//! Run with `cargo bench --bench decode_simulation`. Environment knobs:
+//!
+//! - `XGRAMMAR_SIM_STEPS`: total decode steps per trace (default 2000); the
+//!   trace is replayed from a reset matcher until the budget is spent.
+//! - `XGRAMMAR_SIM_TRACES`: path to a JSONL file of traces replacing the
+//!   built-in ones. Each line holds `name`, `text`, an optional
+//!   `rollback_every`, and a `grammar` object with exactly one of
+//!   `builtin_json` (true), `json_schema`, `regex` or `ebnf`.
+
+use std::{
+    alloc::{GlobalAlloc, Layout, System},
+    collections::HashMap,
+    sync::atomic::{AtomicU64, Ordering},
+    time::Instant,
+};
+
+use xgrammar::{
+    CxxUniquePtr, DLDataType, DLDataTypeCode, DLDevice, DLDeviceType, DLTensor,
+    Grammar, GrammarCompiler, GrammarMatcher, TokenizerInfo, VocabType,
+    allocate_token_bitmask, apply_token_bitmask_inplace_cpu, c_void,
+    get_bitmask_shape,
+};
+
+/// Counts allocations so the harness can report allocations per decode
+/// step: a steady-state loop that allocates is a regression even when the
+/// latency numbers still look fine.
+struct CountingAllocator;
+
+static ALLOCATION_COUNT: AtomicU64 = AtomicU64::new(0);
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(
+        &self,
+        layout: Layout,
+    ) -> *mut u8 {
+        ALLOCATION_COUNT.fetch_add(1, Ordering::Relaxed);
+        unsafe { System.alloc(layout) }
+    }
+
+    unsafe fn dealloc(
+        &self,
+        ptr: *mut u8,
+        layout: Layout,
+    ) {
+        unsafe { System.dealloc(ptr, layout) }
+    }
+
+    unsafe fn realloc(
+        &self,
+        ptr: *mut u8,
+        layout: Layout,
+        new_size: usize,
+    ) -> *mut u8 {
+        ALLOCATION_COUNT.fetch_add(1, Ordering::Relaxed);
+        unsafe { System.realloc(ptr, layout, new_size) }
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+#[derive(Clone)]
+enum TraceGrammar {
+    BuiltinJson,
+    JsonSchema(String),
+    Regex(String),
+    Ebnf(String),
+}
+
+#[derive(Clone)]
+struct Trace {
+    name: String,
+    grammar: TraceGrammar,
+    text: String,
+    rollback_every: usize, // 0 disables the rollback phase
+}
+
+const SCHEMA: &str = r#"{
+    "type": "object",
+    "properties": {
+        "name": {"type": "string"},
+        "age": {"type": "integer", "minimum": 0},
+        "active": {"type": "boolean"},
+        "scores": {"type": "array", "items": {"type": "number"}}
+    },
+    "required": ["name", "age"]
+}"#;
+
+fn builtin_traces() -> Vec<Trace> {
+    vec![
+        Trace {
+            name: "json_schema/profile".to_string(),
+            grammar: TraceGrammar::JsonSchema(SCHEMA.to_string()),
+            text: r#"{"name": "John", "age": 42, "active": true, "scores": [1.5, 2.0, 9]}"#
+                .to_string(),
+            rollback_every: 50,
+        },
+        Trace {
+            name: "builtin_json/nested".to_string(),
+            grammar: TraceGrammar::BuiltinJson,
+            text: r#"{"items": [{"id": 1, "tag": "alpha"}, {"id": 2, "tag": "beta"}], "total": 2}"#
+                .to_string(),
+            rollback_every: 0,
+        },
+        Trace {
+            name: "regex/phone".to_string(),
+            grammar: TraceGrammar::Regex(
+                r"[0-9]{3}-[0-9]{3}-[0-9]{4}".to_string(),
+            ),
+            text: "123-456-7890".to_string(),
+            rollback_every: 4,
+        },
+    ]
+}
+
+fn parse_trace_line(line: &str) -> Trace {
+    let value: serde_json::Value =
+        serde_json::from_str(line).expect("trace line is not valid JSON");
+    let grammar_obj = &value["grammar"];
+    let grammar = if grammar_obj["builtin_json"].as_bool() == Some(true) {
+        TraceGrammar::BuiltinJson
+    } else if let Some(schema) = grammar_obj["json_schema"].as_str() {
+        TraceGrammar::JsonSchema(schema.to_string())
+    } else if let Some(regex) = grammar_obj["regex"].as_str() {
+        TraceGrammar::Regex(regex.to_string())
+    } else if let Some(ebnf) = grammar_obj["ebnf"].as_str() {
+        TraceGrammar::Ebnf(ebnf.to_string())
+    } else {
+        panic!(
+            "trace grammar must set builtin_json, json_schema, regex or ebnf"
+        );
+    };
+    Trace {
+        name: value["name"].as_str().unwrap_or("unnamed").to_string(),
+        grammar,
+        text: value["text"]
+            .as_str()
+            .expect("trace is missing `text`")
+            .to_string(),
+        rollback_every: value["rollback_every"].as_u64().unwrap_or(0) as usize,
+    }
+}
+
+fn load_traces() -> Vec<Trace> {
+    match std::env::var("XGRAMMAR_SIM_TRACES") {
+        Ok(path) => {
+            let contents = std::fs::read_to_string(&path)
+                .unwrap_or_else(|e| panic!("cannot read {path}: {e}"));
+            contents
+                .lines()
+                .filter(|l| !l.trim().is_empty())
+                .map(parse_trace_line)
+                .collect()
+        },
+        Err(_) => builtin_traces(),
+    }
+}
+
+/// A synthetic vocabulary: JSON structural tokens, all printable ASCII
+/// single characters (so any trace text tokenizes), a few multi-character
+/// common tokens, padded with generated word tokens up to `size`.
+fn synthetic_vocab(size: usize) -> Vec<String> {
+    let mut vocab: Vec<String> =
+        ["{\"", "\":", "\", \"", "true", "false", "null", "\"}", "}, {", "],"]
+            .iter()
+            .map(|s| s.to_string())
+            .collect();
+    for c in 0x20u8..0x7f {
+        vocab.push((c as char).to_string());
+    }
+    let mut i = 0usize;
+    while vocab.len() < size {
+        vocab.push(format!("word{i}"));
+        i += 1;
+    }
+    vocab
+}
+
+/// Greedy longest-match tokenization of the trace text against the
+/// synthetic vocabulary. Any tokenization of grammar-valid text is valid
+/// for the matcher, so greedy is fine for a simulation.
+fn tokenize(
+    text: &str,
+    vocab: &[String],
+) -> Vec<i32> {
+    let lookup: HashMap<&str, i32> = vocab
+        .iter()
+        .enumerate()
+        .map(|(id, tok)| (tok.as_str(), id as i32))
+        .collect();
+    let max_len = vocab.iter().map(|t| t.len()).max().unwrap_or(1);
+    let mut tokens = Vec::new();
+    let mut rest = text;
+    while !rest.is_empty() {
+        let mut matched = None;
+        for len in (1..=max_len.min(rest.len())).rev() {
+            if !rest.is_char_boundary(len) {
+                continue;
+            }
+            if let Some(&id) = lookup.get(&rest[..len]) {
+                matched = Some((id, len));
+                break;
+            }
+        }
+        let (id, len) = matched.unwrap_or_else(|| {
+            let head: String = rest.chars().take(20).collect();
+            panic!("trace text not tokenizable at: {head:?}")
+        });
+        tokens.push(id);
+        rest = &rest[len..];
+    }
+    tokens
+}
+
+fn make_bitmask_tensor(
+    bitmask_data: &mut [i32],
+    vocab_size: usize,
+) -> (CxxUniquePtr<DLTensor>, Vec<i64>, Vec<i64>) {
+    let (_, bitmask_size) = get_bitmask_shape(1, vocab_size);
+    let mut shape = vec![1i64, bitmask_size as i64];
+    let mut strides = vec![bitmask_size as i64, 1];
+    let tensor = unsafe {
+        DLTensor::new(
+            bitmask_data.as_mut_ptr() as *mut c_void,
+            DLDevice {
+                device_type: DLDeviceType::kDLCPU,
+                device_id: 0,
+            },
+            2,
+            DLDataType {
+                code: DLDataTypeCode::kDLInt as u8,
+                bits: 32,
+                lanes: 1,
+            },
+            shape.as_mut_ptr(),
+            strides.as_mut_ptr(),
+            0,
+        )
+    };
+    (tensor, shape, strides)
+}
+
+fn make_logits_tensor(
+    logits: &mut [f32]
+) -> (CxxUniquePtr<DLTensor>, Vec<i64>, Vec<i64>) {
+    let mut shape = vec![logits.len() as i64];
+    let mut strides = vec![1i64];
+    let tensor = unsafe {
+        DLTensor::new(
+            logits.as_mut_ptr() as *mut c_void,
+            DLDevice {
+                device_type: DLDeviceType::kDLCPU,
+                device_id: 0,
+            },
+            1,
+            DLDataType {
+                code: DLDataTypeCode::kDLFloat as u8,
+                bits: 32,
+                lanes: 1,
+            },
+            shape.as_mut_ptr(),
+            strides.as_mut_ptr(),
+            0,
+        )
+    };
+    (tensor, shape, strides)
+}
+
+/// Per-phase samples: nanoseconds per step and allocations per step.
+#[derive(Default)]
+struct PhaseStats {
+    nanos: Vec<u64>,
+    allocations: u64,
+}
+
+impl PhaseStats {
+    fn record<T>(
+        &mut self,
+        f: impl FnOnce() -> T,
+    ) -> T {
+        let allocations_before = ALLOCATION_COUNT.load(Ordering::Relaxed);
+        let start = Instant::now();
+        let result = f();
+        self.nanos.push(start.elapsed().as_nanos() as u64);
+        self.allocations += ALLOCATION_COUNT
+            .load(Ordering::Relaxed)
+            .saturating_sub(allocations_before);
+        result
+    }
+
+    fn report(
+        &self,
+        label: &str,
+    ) {
+        let mut sorted = self.nanos.clone();
+        sorted.sort_unstable();
+        let steps = sorted.len().max(1) as u64;
+        println!(
+            "  {label:<14} p50 {:>8.1}us  p90 {:>8.1}us  p99 {:>8.1}us  \
+             max {:>8.1}us  allocs/step {:.2}",
+            percentile(&sorted, 50.0) as f64 / 1000.0,
+            percentile(&sorted, 90.0) as f64 / 1000.0,
+            percentile(&sorted, 99.0) as f64 / 1000.0,
+            sorted.last().copied().unwrap_or(0) as f64 / 1000.0,
+            self.allocations as f64 / steps as f64,
+        );
+    }
+}
+
+fn percentile(
+    sorted: &[u64],
+    p: f64,
+) -> u64 {
+    if sorted.is_empty() {
+        return 0;
+    }
+    let rank = ((sorted.len() - 1) as f64 * p / 100.0).round() as usize;
+    sorted[rank]
+}
+
+fn peak_rss_bytes() -> Option<u64> {
+    #[cfg(target_os = "linux")]
+    {
+        let status = std::fs::read_to_string("/proc/self/status").ok()?;
+        let line = status.lines().find(|l| l.starts_with("VmHWM:"))?;
+        let kib: u64 = line.split_whitespace().nth(1)?.parse().ok()?;
+        return Some(kib * 1024);
+    }
+    #[cfg(not(target_os = "linux"))]
+    None
+}
+
+/// Replays one trace for `target_steps` decode steps. Returns the number of
+/// steps where the sampled token diverged from the trace (mask rejected a
+/// valid token) — any non-zero count is a correctness failure.
+fn run_trace(
+    trace: &Trace,
+    vocab: &[String],
+    compiler: &mut GrammarCompiler,
+    target_steps: usize,
+) -> usize {
+    let vocab_size = vocab.len();
+    let compiled = match &trace.grammar {
+        TraceGrammar::BuiltinJson => {
+            compiler.compile_builtin_json_grammar().unwrap()
+        },
+        TraceGrammar::JsonSchema(schema) => compiler
+            .compile_json_schema(
+                schema,
+                true,
+                None,
+                None::<(&str, &str)>,
+                true,
+                None,
+            )
+            .unwrap(),
+        TraceGrammar::Regex(regex) => compiler.compile_regex(regex).unwrap(),
+        TraceGrammar::Ebnf(ebnf) => {
+            let grammar = Grammar::from_ebnf(ebnf, "root").unwrap();
+            compiler.compile_grammar(&grammar).unwrap()
+        },
+    };
+    let tokens = tokenize(&trace.text, vocab);
+    assert!(!tokens.is_empty(), "trace {} has no tokens", trace.name);
+    let mut matcher = GrammarMatcher::new(&compiled, None, false, -1).unwrap();
+
+    let mut bitmask_data = allocate_token_bitmask(1, vocab_size);
+    let (mut bitmask_tensor, _bshape, _bstrides) =
+        make_bitmask_tensor(&mut bitmask_data, vocab_size);
+    let mut logits = vec![0f32; vocab_size];
+    let (mut logits_tensor, _lshape, _lstrides) =
+        make_logits_tensor(&mut logits);
+
+    let mut fill = PhaseStats::default();
+    let mut apply = PhaseStats::default();
+    let mut sample = PhaseStats::default();
+    let mut accept = PhaseStats::default();
+    let mut rollback = PhaseStats::default();
+
+    let mut divergences = 0usize;
+    let mut steps = 0usize;
+    'outer: while steps < target_steps {
+        matcher.reset();
+        for (position, &expected) in tokens.iter().enumerate() {
+            if steps >= target_steps {
+                break 'outer;
+            }
+            steps += 1;
+
+            fill.record(|| {
+                assert!(matcher.fill_next_token_bitmask(
+                    &mut bitmask_tensor,
+                    0,
+                    false
+                ));
+            });
+
+            // The mock "model" prefers the trace token; everything else
+            // gets a deterministic low logit.
+            for (id, logit) in logits.iter_mut().enumerate() {
+                *logit = (id % 7) as f32 * 0.1;
+            }
+            logits[expected as usize] = 10.0;
+
+            apply.record(|| {
+                apply_token_bitmask_inplace_cpu(
+                    &mut logits_tensor,
+                    &bitmask_tensor,
+                    Some(vocab_size as i32),
+                    None,
+                )
+                .unwrap();
+            });
+
+            let sampled = sample.record(|| {
+                let mut best = 0usize;
+                for (id, &logit) in logits.iter().enumerate() {
+                    if logit > logits[best] {
+                        best = id;
+                    }
+                }
+                best as i32
+            });
+            if sampled != expected {
+                divergences += 1;
+                break;
+            }
+
+            accept.record(|| {
+                assert!(matcher.accept_token(expected));
+            });
+
+            if trace.rollback_every != 0
+                && position != 0
+                && steps % trace.rollback_every == 0
+            {
+                rollback.record(|| {
+                    matcher.rollback(1);
+                    assert!(matcher.accept_token(expected));
+                });
+            }
+        }
+    }
+
+    println!(
+        "trace {} ({} steps, {} tokens/pass):",
+        trace.name,
+        steps,
+        tokens.len()
+    );
+    fill.report("fill_bitmask");
+    apply.report("apply_bitmask");
+    sample.report("sample");
+    accept.report("accept_token");
+    if trace.rollback_every != 0 {
+        rollback.report("rollback");
+    }
+    divergences
+}
+
+fn main() {
+    let target_steps: usize = std::env::var("XGRAMMAR_SIM_STEPS")
+        .ok()
+        .and_then(|v| v.parse().ok())
+        .unwrap_or(2000);
+    let traces = load_traces();
+
+    let vocab = synthetic_vocab(32_000);
+    let vocab_refs: Vec<&str> = vocab.iter().map(|s| s.as_str()).collect();
+    let stop_ids: Option<Box<[i32]>> = None;
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab_refs, VocabType::RAW, &stop_ids, false)
+            .unwrap();
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 8, true, -1).unwrap();
+
+    let mut total_divergences = 0usize;
+    for trace in &traces {
+        total_divergences +=
+            run_trace(trace, &vocab, &mut compiler, target_steps);
+    }
+
+    match peak_rss_bytes() {
+        Some(bytes) => {
+            println!("peak RSS: {:.1} MiB", bytes as f64 / (1024.0 * 1024.0))
+        },
+        None => println!("peak RSS: unavailable on this platform"),
+    }
+
+    if total_divergences != 0 {
+        eprintln!(
+            "{total_divergences} step(s) diverged from the trace: the mask \
+             rejected a token the grammar allows"
+        );
+        std::process::exit(1);
+    }
+}
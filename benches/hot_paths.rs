@@ -0,0 +1,313 @@
+//! Micro-benchmarks for the decode-loop hot paths: bitmask fill, token
+//! accept/rollback, the batch matcher operations, CPU logits masking, and
+//! JSON-schema compilation. The `ffi_overhead` group times no-op glue
+//! crossings so the fixed bridge cost can be subtracted from the other
+//! numbers and engine regressions separated from binding regressions.
+//!
+//! Run with `cargo bench`.
+
+use criterion::{Criterion, black_box, criterion_group, criterion_main};
+use xgrammar::{
+    BatchGrammarMatcher, CxxUniquePtr, DLDataType, DLDataTypeCode, DLDevice,
+    DLDeviceType, DLTensor, GrammarCompiler, GrammarMatcher, TokenizerInfo,
+    VocabType, allocate_token_bitmask, apply_token_bitmask_inplace_cpu, c_void,
+    get_bitmask_shape, testing,
+};
+
+/// A synthetic vocabulary with the structural tokens a JSON grammar needs,
+/// padded with generated word tokens up to `size`. Large enough to make the
+/// bitmask fill representative without downloading a real tokenizer.
+fn synthetic_vocab(size: usize) -> Vec<String> {
+    let mut vocab: Vec<String> = [
+        "{", "}", "[", "]", "\"", ":", ",", " ", "-", ".", "true", "false",
+        "null", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+    ]
+    .iter()
+    .map(|s| s.to_string())
+    .collect();
+    let mut i = 0usize;
+    while vocab.len() < size {
+        vocab.push(format!("word{i}"));
+        i += 1;
+    }
+    vocab
+}
+
+const SCHEMA: &str = r#"{
+    "type": "object",
+    "properties": {
+        "name": {"type": "string"},
+        "age": {"type": "integer", "minimum": 0},
+        "email": {"type": "string"},
+        "active": {"type": "boolean"},
+        "scores": {"type": "array", "items": {"type": "number"}},
+        "address": {
+            "type": "object",
+            "properties": {
+                "street": {"type": "string"},
+                "city": {"type": "string"},
+                "zip": {"type": "string"}
+            },
+            "required": ["street", "city"]
+        }
+    },
+    "required": ["name", "age"]
+}"#;
+
+fn make_tokenizer_info(vocab_size: usize) -> TokenizerInfo {
+    let vocab = synthetic_vocab(vocab_size);
+    let vocab_refs: Vec<&str> = vocab.iter().map(|s| s.as_str()).collect();
+    let stop_ids: Option<Box<[i32]>> = None;
+    TokenizerInfo::new(&vocab_refs, VocabType::RAW, &stop_ids, false).unwrap()
+}
+
+fn make_bitmask_tensor(
+    bitmask_data: &mut [i32],
+    batch_size: usize,
+    vocab_size: usize,
+) -> (CxxUniquePtr<DLTensor>, Vec<i64>, Vec<i64>) {
+    let (_, bitmask_size) = get_bitmask_shape(batch_size, vocab_size);
+    let mut shape = vec![batch_size as i64, bitmask_size as i64];
+    let mut strides = vec![bitmask_size as i64, 1];
+    let tensor = unsafe {
+        DLTensor::new(
+            bitmask_data.as_mut_ptr() as *mut c_void,
+            DLDevice {
+                device_type: DLDeviceType::kDLCPU,
+                device_id: 0,
+            },
+            2,
+            DLDataType {
+                code: DLDataTypeCode::kDLInt as u8,
+                bits: 32,
+                lanes: 1,
+            },
+            shape.as_mut_ptr(),
+            strides.as_mut_ptr(),
+            0,
+        )
+    };
+    (tensor, shape, strides)
+}
+
+fn make_logits_tensor(
+    logits: &mut [f32]
+) -> (CxxUniquePtr<DLTensor>, Vec<i64>, Vec<i64>) {
+    let mut shape = vec![logits.len() as i64];
+    let mut strides = vec![1i64];
+    let tensor = unsafe {
+        DLTensor::new(
+            logits.as_mut_ptr() as *mut c_void,
+            DLDevice {
+                device_type: DLDeviceType::kDLCPU,
+                device_id: 0,
+            },
+            1,
+            DLDataType {
+                code: DLDataTypeCode::kDLFloat as u8,
+                bits: 32,
+                lanes: 1,
+            },
+            shape.as_mut_ptr(),
+            strides.as_mut_ptr(),
+            0,
+        )
+    };
+    (tensor, shape, strides)
+}
+
+/// Find a token the matcher currently allows, for accept/rollback cycling.
+fn first_allowed_token(
+    matcher: &mut GrammarMatcher,
+    vocab_size: usize,
+) -> i32 {
+    let mut bitmask_data = allocate_token_bitmask(1, vocab_size);
+    let (mut tensor, _shape, _strides) =
+        make_bitmask_tensor(&mut bitmask_data, 1, vocab_size);
+    matcher.fill_next_token_bitmask(&mut tensor, 0, false);
+    for token_id in 0..vocab_size as i32 {
+        let word = (token_id / 32) as usize;
+        let bit = token_id % 32;
+        if bitmask_data[word] & (1 << bit) != 0 {
+            return token_id;
+        }
+    }
+    panic!("no token allowed");
+}
+
+fn bench_fill_next_token_bitmask(c: &mut Criterion) {
+    let vocab_size = 32_000usize;
+    let tokenizer_info = make_tokenizer_info(vocab_size);
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let compiled = compiler
+        .compile_json_schema(
+            SCHEMA,
+            true,
+            None,
+            None::<(&str, &str)>,
+            true,
+            None,
+        )
+        .unwrap();
+    let mut matcher = GrammarMatcher::new(&compiled, None, true, -1).unwrap();
+
+    let mut bitmask_data = allocate_token_bitmask(1, vocab_size);
+    let (mut tensor, _shape, _strides) =
+        make_bitmask_tensor(&mut bitmask_data, 1, vocab_size);
+
+    c.bench_function("fill_next_token_bitmask/32k_vocab", |b| {
+        b.iter(|| {
+            black_box(matcher.fill_next_token_bitmask(
+                black_box(&mut tensor),
+                0,
+                false,
+            ))
+        })
+    });
+}
+
+fn bench_accept_token(c: &mut Criterion) {
+    let vocab_size = 32_000usize;
+    let tokenizer_info = make_tokenizer_info(vocab_size);
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let compiled = compiler.compile_builtin_json_grammar().unwrap();
+    // Rollback support so each iteration can undo its accept and keep the
+    // matcher state (and thus the per-iteration work) constant.
+    let mut matcher = GrammarMatcher::new(&compiled, None, false, 8).unwrap();
+    let token_id = first_allowed_token(&mut matcher, vocab_size);
+
+    c.bench_function("accept_token_rollback/json_grammar", |b| {
+        b.iter(|| {
+            black_box(matcher.accept_token(black_box(token_id)));
+            matcher.rollback(1);
+        })
+    });
+}
+
+fn bench_batch_ops(c: &mut Criterion) {
+    let vocab_size = 32_000usize;
+    let batch_size = 16usize;
+    let tokenizer_info = make_tokenizer_info(vocab_size);
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let compiled = compiler
+        .compile_json_schema(
+            SCHEMA,
+            true,
+            None,
+            None::<(&str, &str)>,
+            true,
+            None,
+        )
+        .unwrap();
+    let mut matchers: Vec<GrammarMatcher> = (0..batch_size)
+        .map(|_| GrammarMatcher::new(&compiled, None, false, 8).unwrap())
+        .collect();
+    let token_id = first_allowed_token(&mut matchers[0], vocab_size);
+
+    let mut batch_matcher = BatchGrammarMatcher::new_auto().unwrap();
+    let mut bitmask_data = allocate_token_bitmask(batch_size, vocab_size);
+    let (mut tensor, _shape, _strides) =
+        make_bitmask_tensor(&mut bitmask_data, batch_size, vocab_size);
+
+    c.bench_function("batch_fill_next_token_bitmask/16x32k", |b| {
+        b.iter(|| {
+            batch_matcher
+                .batch_fill_next_token_bitmask(
+                    black_box(&matchers),
+                    black_box(&mut tensor),
+                    None,
+                    false,
+                )
+                .unwrap()
+        })
+    });
+
+    let tokens = vec![token_id; batch_size];
+    let rollbacks = vec![1i32; batch_size];
+    c.bench_function("batch_accept_token_rollback/16x32k", |b| {
+        b.iter(|| {
+            black_box(
+                BatchGrammarMatcher::batch_accept_token(
+                    black_box(&matchers),
+                    black_box(&tokens),
+                    false,
+                )
+                .unwrap(),
+            );
+            BatchGrammarMatcher::batch_rollback(&matchers, &rollbacks).unwrap();
+        })
+    });
+}
+
+fn bench_apply_token_bitmask(c: &mut Criterion) {
+    let vocab_size = 128_000usize;
+    let mut bitmask_data = allocate_token_bitmask(1, vocab_size);
+    // Mask out every other 32-token block so the kernel does real work.
+    for (i, word) in bitmask_data.iter_mut().enumerate() {
+        if i % 2 == 0 {
+            *word = 0;
+        }
+    }
+    let (bitmask_tensor, _bshape, _bstrides) =
+        make_bitmask_tensor(&mut bitmask_data, 1, vocab_size);
+    let mut logits = vec![0.5f32; vocab_size];
+    let (mut logits_tensor, _lshape, _lstrides) =
+        make_logits_tensor(&mut logits);
+
+    c.bench_function("apply_token_bitmask_inplace_cpu/128k_vocab", |b| {
+        b.iter(|| {
+            apply_token_bitmask_inplace_cpu(
+                black_box(&mut logits_tensor),
+                black_box(&bitmask_tensor),
+                Some(vocab_size as i32),
+                None,
+            )
+            .unwrap()
+        })
+    });
+}
+
+fn bench_compile_json_schema(c: &mut Criterion) {
+    let tokenizer_info = make_tokenizer_info(32_000);
+    // Cache disabled so every iteration measures a real compilation.
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+
+    c.bench_function("compile_json_schema/32k_vocab", |b| {
+        b.iter(|| {
+            compiler
+                .compile_json_schema(
+                    black_box(SCHEMA),
+                    true,
+                    None,
+                    None::<(&str, &str)>,
+                    true,
+                    None,
+                )
+                .unwrap()
+        })
+    });
+}
+
+fn bench_ffi_overhead(c: &mut Criterion) {
+    c.bench_function("ffi_overhead/noop", |b| b.iter(testing::bench_ffi_noop));
+
+    let values = vec![0i32; 16];
+    c.bench_function("ffi_overhead/noop_status", |b| {
+        b.iter(|| testing::bench_ffi_noop_status(black_box(&values)).unwrap())
+    });
+}
+
+criterion_group!(
+    benches,
+    bench_fill_next_token_bitmask,
+    bench_accept_token,
+    bench_batch_ops,
+    bench_apply_token_bitmask,
+    bench_compile_json_schema,
+    bench_ffi_overhead,
+);
+criterion_main!(benches);
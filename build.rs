@@ -24,6 +24,15 @@ fn main() {
         println!("cargo::rustc-link-lib=static=unwind");
         wasm_c_cxx_flags =
             vec!["-fwasm-exceptions", "-mllvm", "-wasm-use-legacy-eh=false"];
+        // Mirror the Rust-side `+simd128` target feature into the C++
+        // builds, so the SIMD128 kernels in `bitmask_kernels.hpp` (guarded
+        // by `__wasm_simd128__`) and the engine itself compile to vector
+        // code instead of the scalar fallbacks.
+        let target_features =
+            env::var("CARGO_CFG_TARGET_FEATURE").unwrap_or_default();
+        if target_features.split(',').any(|f| f == "simd128") {
+            wasm_c_cxx_flags.push("-msimd128");
+        }
     }
 
     let destination_path =
@@ -0,0 +1,146 @@
+//! Versioned binary container for serialized XGrammar objects.
+//!
+//! The container wraps the engine's serialized payload in a fixed header
+//! (magic, container version, payload kind, engine serialization version and
+//! payload length), so incompatible or foreign files are rejected by reading
+//! a few bytes instead of parsing the whole payload. The payload itself is
+//! currently the engine's JSON serialization; when the engine grows a binary,
+//! mmap-friendly serializer the payload can be swapped behind the same
+//! container without changing the file-level versioning.
+
+use crate::{DeserializeError, get_serialization_version};
+
+/// File magic: "XGBF" = XGrammar Binary Format.
+const MAGIC: [u8; 4] = *b"XGBF";
+
+/// Version of the container layout itself, independent of the engine
+/// serialization version carried in the header.
+const CONTAINER_VERSION: u16 = 1;
+
+/// Identifies what the payload deserializes into, so a `TokenizerInfo` file
+/// is never fed to the `CompiledGrammar` deserializer by mistake.
+#[derive(Clone, Copy, PartialEq, Eq)]
+pub(crate) enum PayloadKind {
+    CompiledGrammar = 1,
+    TokenizerInfo = 2,
+    MatcherSnapshot = 3,
+    GrammarBundle = 4,
+}
+
+impl PayloadKind {
+    fn name(self) -> &'static str {
+        match self {
+            Self::CompiledGrammar => "CompiledGrammar",
+            Self::TokenizerInfo => "TokenizerInfo",
+            Self::MatcherSnapshot => "MatcherSnapshot",
+            Self::GrammarBundle => "GrammarBundle",
+        }
+    }
+}
+
+/// Wrap `payload` in a container of the given kind, stamped with the current
+/// engine serialization version.
+pub(crate) fn encode(
+    kind: PayloadKind,
+    payload: &[u8],
+) -> Vec<u8> {
+    let version = get_serialization_version();
+    let mut out = Vec::with_capacity(
+        MAGIC.len() + 2 + 1 + 1 + version.len() + 8 + payload.len(),
+    );
+    out.extend_from_slice(&MAGIC);
+    out.extend_from_slice(&CONTAINER_VERSION.to_le_bytes());
+    out.push(kind as u8);
+    out.push(
+        u8::try_from(version.len())
+            .expect("serialization version string too long"),
+    );
+    out.extend_from_slice(version.as_bytes());
+    out.extend_from_slice(&(payload.len() as u64).to_le_bytes());
+    out.extend_from_slice(payload);
+    out
+}
+
+/// Validate the container header and return the payload slice.
+///
+/// The header is checked field by field before the payload is touched:
+/// magic and container version (`Format` errors), payload kind (`Format`),
+/// engine serialization version (`VersionMismatch`) and payload length
+/// (`Format`).
+pub(crate) fn decode(
+    kind: PayloadKind,
+    bytes: &[u8],
+) -> Result<&[u8], DeserializeError> {
+    fn take<'a>(
+        rest: &mut &'a [u8],
+        n: usize,
+        what: &str,
+    ) -> Result<&'a [u8], DeserializeError> {
+        if rest.len() < n {
+            return Err(DeserializeError::Format(format!(
+                "truncated binary container: missing {what}"
+            )));
+        }
+        let (head, tail) = rest.split_at(n);
+        *rest = tail;
+        Ok(head)
+    }
+
+    let rest = &mut &bytes[..];
+    if take(rest, MAGIC.len(), "magic")? != MAGIC {
+        return Err(DeserializeError::Format(
+            "not an XGrammar binary container (bad magic)".to_string(),
+        ));
+    }
+    let container_version = u16::from_le_bytes(
+        take(rest, 2, "container version")?.try_into().unwrap(),
+    );
+    if container_version != CONTAINER_VERSION {
+        return Err(DeserializeError::Format(format!(
+            "unsupported binary container version {container_version} \
+             (expected {CONTAINER_VERSION})"
+        )));
+    }
+    let kind_byte = take(rest, 1, "payload kind")?[0];
+    if kind_byte != kind as u8 {
+        return Err(DeserializeError::Format(format!(
+            "binary container holds payload kind {kind_byte}, expected {} ({})",
+            kind as u8,
+            kind.name()
+        )));
+    }
+    let version_len = usize::from(take(rest, 1, "version length")?[0]);
+    let version_bytes = take(rest, version_len, "serialization version")?;
+    let current = get_serialization_version();
+    if version_bytes != current.as_bytes() {
+        return Err(DeserializeError::VersionMismatch(format!(
+            "binary container was produced by serialization version {}, \
+             current version is {current}",
+            String::from_utf8_lossy(version_bytes)
+        )));
+    }
+    let payload_len = u64::from_le_bytes(
+        take(rest, 8, "payload length")?.try_into().unwrap(),
+    );
+    if payload_len != rest.len() as u64 {
+        return Err(DeserializeError::Format(format!(
+            "binary container declares {payload_len} payload bytes but \
+             {} remain",
+            rest.len()
+        )));
+    }
+    Ok(*rest)
+}
+
+/// Decode a container whose payload is the engine's JSON serialization.
+pub(crate) fn decode_json_payload(
+    kind: PayloadKind,
+    bytes: &[u8],
+) -> Result<&str, DeserializeError> {
+    let payload = decode(kind, bytes)?;
+    std::str::from_utf8(payload).map_err(|e| {
+        DeserializeError::Format(format!(
+            "binary container payload is not valid UTF-8: {e}"
+        ))
+    })
+}
@@ -0,0 +1,303 @@
+//! Indexed archive of precompiled grammars for fast worker startup.
+//!
+//! A deployment that serves a fixed set of schemas can compile every grammar
+//! once, offline, and pack the results into a single archive file. Workers
+//! then open the archive at boot instead of recompiling: opening parses only
+//! the fixed-size header and the index table, and each grammar is
+//! deserialized lazily on first lookup, so cold-start cost no longer scales
+//! with the number of schemas shipped.
+//!
+//! The archive reuses the versioned container from [`crate::binary_format`],
+//! so a bundle produced by an incompatible engine build is rejected from its
+//! header before any entry is touched. Entries are keyed by a caller-chosen
+//! `u64` — use a stable content hash of the compilation inputs (as the
+//! compiler caches do), never a pointer or a per-process hash.
+//!
+//! The engine only exposes a JSON (de)serialization for compiled grammars,
+//! so entries cannot be mapped into place; the archive instead keeps the raw
+//! bytes in memory and defers the expensive part — deserialization — until
+//! an entry is actually used.
+
+use std::{collections::BTreeMap, collections::HashMap, fs, path::Path};
+
+use crate::{CompiledGrammar, DeserializeError, TokenizerInfo, binary_format};
+
+/// Builds a grammar bundle offline, one entry at a time.
+///
+/// Entries are stored sorted by key, so the same set of grammars always
+/// produces byte-identical archives regardless of insertion order. Adding a
+/// second entry under an existing key replaces the first.
+pub struct GrammarBundleBuilder {
+    entries: BTreeMap<u64, String>,
+}
+
+impl GrammarBundleBuilder {
+    pub fn new() -> Self {
+        Self {
+            entries: BTreeMap::new(),
+        }
+    }
+
+    /// Add a compiled grammar under the given key.
+    pub fn add(
+        &mut self,
+        key: u64,
+        compiled_grammar: &CompiledGrammar,
+    ) -> &mut Self {
+        self.entries.insert(key, compiled_grammar.serialize_json());
+        self
+    }
+
+    /// The number of entries added so far.
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Serialize the bundle into a versioned binary container (the same
+    /// container format `CompiledGrammar::serialize_bytes` uses).
+    ///
+    /// Layout of the payload: an entry count, then an index table of
+    /// `(key, offset, length)` triples, then the concatenated entry bodies.
+    /// Offsets are relative to the start of the body section so the index
+    /// can be parsed without knowing the header size.
+    pub fn to_bytes(&self) -> Vec<u8> {
+        let body_len: usize =
+            self.entries.values().map(String::len).sum::<usize>();
+        let mut payload =
+            Vec::with_capacity(4 + 24 * self.entries.len() + body_len);
+        payload.extend_from_slice(&(self.entries.len() as u32).to_le_bytes());
+        let mut offset = 0u64;
+        for (key, json) in &self.entries {
+            payload.extend_from_slice(&key.to_le_bytes());
+            payload.extend_from_slice(&offset.to_le_bytes());
+            payload.extend_from_slice(&(json.len() as u64).to_le_bytes());
+            offset += json.len() as u64;
+        }
+        for json in self.entries.values() {
+            payload.extend_from_slice(json.as_bytes());
+        }
+        binary_format::encode(
+            binary_format::PayloadKind::GrammarBundle,
+            &payload,
+        )
+    }
+
+    /// Write the bundle to a file, atomically (temp file + rename).
+    ///
+    /// # Errors
+    ///
+    /// Returns an error when the file cannot be written.
+    pub fn write_to(
+        &self,
+        path: &Path,
+    ) -> Result<(), String> {
+        let tmp = path.with_extension(format!("tmp{}", std::process::id()));
+        fs::write(&tmp, self.to_bytes()).map_err(|e| {
+            format!("failed to write grammar bundle {}: {e}", tmp.display())
+        })?;
+        fs::rename(&tmp, path).map_err(|e| {
+            format!(
+                "failed to move grammar bundle into place at {}: {e}",
+                path.display()
+            )
+        })
+    }
+}
+
+impl Default for GrammarBundleBuilder {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// The byte range of one bundle entry within the body section.
+struct EntrySpan {
+    offset: usize,
+    len: usize,
+}
+
+/// A loaded grammar bundle with lazy entry materialization.
+///
+/// Opening a bundle validates the container header and parses the index
+/// table; no grammar is deserialized until it is first requested through
+/// [`GrammarBundle::get`], and each entry is deserialized at most once. The
+/// loader is single-threaded by design, like the rest of the crate's wrapper
+/// types; wrap it in a lock to share it across threads.
+pub struct GrammarBundle {
+    bytes: Vec<u8>,
+    /// Offset of the body section within `bytes`.
+    body_start: usize,
+    index: HashMap<u64, EntrySpan>,
+    materialized: HashMap<u64, CompiledGrammar>,
+}
+
+impl GrammarBundle {
+    /// Open a bundle from archive bytes produced by
+    /// `GrammarBundleBuilder::to_bytes`.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the container header is malformed, holds a
+    /// different payload kind, was produced by an incompatible serialization
+    /// version, or the index is truncated or inconsistent.
+    pub fn from_bytes(bytes: Vec<u8>) -> Result<Self, DeserializeError> {
+        let payload = binary_format::decode(
+            binary_format::PayloadKind::GrammarBundle,
+            &bytes,
+        )?;
+        let payload_start = bytes.len() - payload.len();
+
+        fn take<'a>(
+            rest: &mut &'a [u8],
+            n: usize,
+            what: &str,
+        ) -> Result<&'a [u8], DeserializeError> {
+            if rest.len() < n {
+                return Err(DeserializeError::Format(format!(
+                    "truncated grammar bundle: missing {what}"
+                )));
+            }
+            let (head, tail) = rest.split_at(n);
+            *rest = tail;
+            Ok(head)
+        }
+
+        let rest = &mut &payload[..];
+        let count = u32::from_le_bytes(
+            take(rest, 4, "entry count")?.try_into().unwrap(),
+        ) as usize;
+        let mut index = HashMap::with_capacity(count);
+        let mut spans = Vec::with_capacity(count);
+        for _ in 0..count {
+            let key = u64::from_le_bytes(
+                take(rest, 8, "entry key")?.try_into().unwrap(),
+            );
+            let offset = u64::from_le_bytes(
+                take(rest, 8, "entry offset")?.try_into().unwrap(),
+            ) as usize;
+            let len = u64::from_le_bytes(
+                take(rest, 8, "entry length")?.try_into().unwrap(),
+            ) as usize;
+            spans.push((key, offset, len));
+        }
+        let body_len = rest.len();
+        for (key, offset, len) in spans {
+            if offset.checked_add(len).is_none_or(|end| end > body_len) {
+                return Err(DeserializeError::Format(format!(
+                    "grammar bundle entry {key:016x} spans bytes \
+                     {offset}..{offset}+{len}, but the body section holds \
+                     only {body_len} bytes"
+                )));
+            }
+            index.insert(
+                key,
+                EntrySpan {
+                    offset,
+                    len,
+                },
+            );
+        }
+        let body_start = payload_start + (payload.len() - body_len);
+        Ok(Self {
+            bytes,
+            body_start,
+            index,
+            materialized: HashMap::new(),
+        })
+    }
+
+    /// Open a bundle file written by `GrammarBundleBuilder::write_to`.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error when the file cannot be read or, as with
+    /// `from_bytes`, when the archive itself is invalid.
+    pub fn open(path: &Path) -> Result<Self, DeserializeError> {
+        let bytes = fs::read(path).map_err(|e| {
+            DeserializeError::Other(format!(
+                "failed to read grammar bundle {}: {e}",
+                path.display()
+            ))
+        })?;
+        Self::from_bytes(bytes)
+    }
+
+    /// The number of entries in the bundle, materialized or not.
+    pub fn len(&self) -> usize {
+        self.index.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.index.is_empty()
+    }
+
+    /// Whether the bundle holds an entry for the given key.
+    pub fn contains(
+        &self,
+        key: u64,
+    ) -> bool {
+        self.index.contains_key(&key)
+    }
+
+    /// The keys of all entries, in no particular order.
+    pub fn keys(&self) -> impl Iterator<Item = u64> + '_ {
+        self.index.keys().copied()
+    }
+
+    /// The number of entries deserialized so far.
+    pub fn materialized_count(&self) -> usize {
+        self.materialized.len()
+    }
+
+    /// Drop the materialized grammar for `key`, releasing its engine-side
+    /// memory while keeping the serialized entry; the next `get` for the key
+    /// deserializes it again. Returns whether a materialized entry was
+    /// dropped.
+    ///
+    /// Together with [`crate::live_compiled_grammar_bytes`] this lets a
+    /// memory-constrained deployment shed rarely used grammars instead of
+    /// growing without bound.
+    pub fn evict(
+        &mut self,
+        key: u64,
+    ) -> bool {
+        self.materialized.remove(&key).is_some()
+    }
+
+    /// Look up the compiled grammar stored under `key`, deserializing it on
+    /// first access and returning the cached result afterwards.
+    ///
+    /// Returns `Ok(None)` when the bundle holds no entry for the key.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error when the entry fails to deserialize, including when
+    /// the tokenizer info metadata does not match the one the grammar was
+    /// compiled against.
+    pub fn get(
+        &mut self,
+        key: u64,
+        tokenizer_info: &TokenizerInfo,
+    ) -> Result<Option<&CompiledGrammar>, DeserializeError> {
+        if !self.materialized.contains_key(&key) {
+            let Some(span) = self.index.get(&key) else {
+                return Ok(None);
+            };
+            let start = self.body_start + span.offset;
+            let body = &self.bytes[start..start + span.len];
+            let json = std::str::from_utf8(body).map_err(|e| {
+                DeserializeError::Format(format!(
+                    "grammar bundle entry {key:016x} is not valid UTF-8: {e}"
+                ))
+            })?;
+            let compiled =
+                CompiledGrammar::deserialize_json(json, tokenizer_info)?;
+            self.materialized.insert(key, compiled);
+        }
+        Ok(self.materialized.get(&key))
+    }
+}
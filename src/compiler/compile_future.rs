@@ -0,0 +1,58 @@
+use crate::{CxxUniquePtr, compiler::CompiledGrammar, ffi};
+
+/// A handle to an in-flight grammar compilation, returned by the
+/// `compile_*_async` methods of `GrammarCompiler`.
+///
+/// The compilation runs on a background thread sharing the compiler's thread
+/// pool and cache, so the caller can overlap compilation with other work
+/// (e.g. prefill) and claim the result when it is actually needed.
+///
+/// Dropping the future does not cancel the compilation; the result is simply
+/// discarded when it completes (it still populates the compiler's cache).
+pub struct CompileFuture {
+    inner: CxxUniquePtr<ffi::CompileFuture>,
+}
+
+impl CompileFuture {
+    /// Whether the compilation has finished, without blocking.
+    pub fn is_ready(&self) -> bool {
+        ffi::compile_future_is_ready(
+            self.inner.as_ref().expect("CompileFuture inner is null"),
+        )
+    }
+
+    /// Block until the compilation finishes and claim the result.
+    ///
+    /// # Returns
+    ///
+    /// The compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the compilation failed.
+    pub fn wait(mut self) -> Result<CompiledGrammar, String> {
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let unique_ptr = unsafe {
+            ffi::compile_future_wait(
+                self.inner.as_mut().expect("CompileFuture inner is null"),
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if unique_ptr.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+    }
+
+    pub(crate) fn from_unique_ptr(
+        inner: cxx::UniquePtr<ffi::CompileFuture>
+    ) -> Self {
+        Self {
+            inner,
+        }
+    }
+}
+
+impl Drop for CompileFuture {
+    fn drop(&mut self) {}
+}
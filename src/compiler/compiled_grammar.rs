@@ -1,6 +1,37 @@
-use std::pin::Pin;
+use std::{
+    pin::Pin,
+    sync::atomic::{AtomicUsize, Ordering},
+};
 
-use crate::{CxxUniquePtr, DeserializeError, Grammar, TokenizerInfo, ffi};
+use crate::{
+    CxxUniquePtr, DeserializeError, Grammar, TokenizerInfo, binary_format, ffi,
+};
+
+/// Process-wide accounting of live `CompiledGrammar` handles; see
+/// [`live_compiled_grammar_bytes`].
+static LIVE_BYTES: AtomicUsize = AtomicUsize::new(0);
+static LIVE_HANDLES: AtomicUsize = AtomicUsize::new(0);
+
+/// The total approximate memory held by all live [`CompiledGrammar`] handles
+/// in this process, in bytes.
+///
+/// The global `cache_limit_bytes` only bounds grammars inside the compiler
+/// cache; a grammar pinned by live matchers is invisible to it. This counter
+/// covers every live handle, so a memory-constrained deployment can watch it
+/// and drop or evict grammars (e.g. from a `GrammarBundle` or `MatcherPool`)
+/// before memory runs out.
+///
+/// Handles that share state (compiler cache hits, bundle lookups) each count
+/// their full size, so the value is an upper bound on the engine-side memory
+/// actually held.
+pub fn live_compiled_grammar_bytes() -> usize {
+    LIVE_BYTES.load(Ordering::Relaxed)
+}
+
+/// The number of live [`CompiledGrammar`] handles in this process.
+pub fn live_compiled_grammar_count() -> usize {
+    LIVE_HANDLES.load(Ordering::Relaxed)
+}
 
 /// This is the primary object to store compiled grammar.
 ///
@@ -12,6 +43,9 @@ use crate::{CxxUniquePtr, DeserializeError, Grammar, TokenizerInfo, ffi};
 /// Do not construct this class directly, instead use `GrammarCompiler` to construct the object.
 pub struct CompiledGrammar {
     inner: CxxUniquePtr<ffi::CompiledGrammar>,
+    /// Size recorded in the live-memory counters at construction, repaid on
+    /// drop.
+    tracked_bytes: usize,
 }
 
 impl CompiledGrammar {
@@ -110,24 +144,85 @@ impl CompiledGrammar {
                 error_out_cxx.to_string(),
             ));
         }
-        Ok(Self {
-            inner: unique_ptr,
-        })
+        Ok(Self::from_unique_ptr(unique_ptr))
+    }
+
+    /// Serialize the compiled grammar to a versioned binary container. Like
+    /// `serialize_json`, the tokenizer info itself is not included; only its
+    /// metadata is embedded and checked on deserialization.
+    ///
+    /// The container header carries the serialization version, so an
+    /// incompatible file is rejected from its first few bytes without
+    /// parsing the payload.
+    ///
+    /// # Returns
+    ///
+    /// The binary container bytes.
+    pub fn serialize_bytes(&self) -> Vec<u8> {
+        binary_format::encode(
+            binary_format::PayloadKind::CompiledGrammar,
+            self.serialize_json().as_bytes(),
+        )
+    }
+
+    /// Deserialize the compiled grammar from a binary container produced by
+    /// `serialize_bytes` and associate it with the specified tokenizer info.
+    ///
+    /// # Parameters
+    ///
+    /// - `bytes`: The binary container bytes.
+    /// - `tokenizer_info`: The tokenizer info.
+    ///
+    /// # Returns
+    ///
+    /// The compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// - When the container header is malformed or holds a different payload
+    ///   kind.
+    /// - When the container was produced by an incompatible serialization
+    ///   version.
+    /// - When the payload fails to deserialize, including when the tokenizer
+    ///   info metadata does not match.
+    pub fn deserialize_bytes(
+        bytes: &[u8],
+        tokenizer_info: &TokenizerInfo,
+    ) -> Result<Self, DeserializeError> {
+        let json = binary_format::decode_json_payload(
+            binary_format::PayloadKind::CompiledGrammar,
+            bytes,
+        )?;
+        Self::deserialize_json(json, tokenizer_info)
     }
 
     pub(crate) fn from_unique_ptr(
         inner: cxx::UniquePtr<ffi::CompiledGrammar>
     ) -> Self {
+        let tracked_bytes =
+            inner.as_ref().map_or(0, |inner_ref| inner_ref.MemorySizeBytes());
+        LIVE_BYTES.fetch_add(tracked_bytes, Ordering::Relaxed);
+        LIVE_HANDLES.fetch_add(1, Ordering::Relaxed);
         Self {
             inner,
+            tracked_bytes,
         }
     }
 
     pub(crate) fn ffi_ref(&self) -> &ffi::CompiledGrammar {
         self.inner.as_ref().expect("CompiledGrammar inner is null")
     }
+
+    /// Cheap handle copy sharing the immutable compiled state; used by
+    /// caches to hand the same result to multiple callers.
+    pub(crate) fn clone_handle(&self) -> Self {
+        Self::from_unique_ptr(ffi::compiled_grammar_clone(self.ffi_ref()))
+    }
 }
 
 impl Drop for CompiledGrammar {
-    fn drop(&mut self) {}
+    fn drop(&mut self) {
+        LIVE_BYTES.fetch_sub(self.tracked_bytes, Ordering::Relaxed);
+        LIVE_HANDLES.fetch_sub(1, Ordering::Relaxed);
+    }
 }
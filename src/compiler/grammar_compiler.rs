@@ -1,9 +1,16 @@
+use std::path::Path;
+
 use crate::{
     CxxUniquePtr,
-    compiler::CompiledGrammar,
+    compiler::{
+        CompiledGrammar,
+        compile_future::CompileFuture,
+        persistent_cache::{ContentHasher, PersistentCache},
+    },
     ffi,
     grammar::{self, StructuralTagItem},
     tokenizer_info::TokenizerInfo,
+    utils::bytes_as_c_char_ptr,
 };
 
 /// The compiler for grammars.
@@ -13,8 +20,22 @@ use crate::{
 /// to store the compilation result, avoiding compiling the same grammar multiple times.
 pub struct GrammarCompiler {
     inner: CxxUniquePtr<ffi::GrammarCompiler>,
+    tokenizer_info: TokenizerInfo,
+    persistent_cache: Option<PersistentCache>,
+    coalescer: CxxUniquePtr<ffi::CompileCoalescer>,
+    /// LRU over compiled structural-tag sets, keyed by an order-independent
+    /// hash of the per-tag items plus the trigger list. Most recently used
+    /// entry last.
+    structural_tag_cache: Vec<(u64, CompiledGrammar)>,
+    structural_tag_cache_hits: u64,
 }
 
+/// The number of compiled structural-tag sets kept in the in-memory LRU.
+/// An agent toggling tools walks a small neighborhood of subsets, so a
+/// modest cache covers it; entries are cheap handles to state the engine
+/// cache holds anyway.
+const STRUCTURAL_TAG_CACHE_CAP: usize = 64;
+
 impl GrammarCompiler {
     /// Construct the compiler.
     ///
@@ -50,9 +71,63 @@ impl GrammarCompiler {
         }
         Ok(Self {
             inner,
+            tokenizer_info: tokenizer_info.clone(),
+            persistent_cache: None,
+            coalescer: ffi::make_compile_coalescer(),
+            structural_tag_cache: Vec::new(),
+            structural_tag_cache_hits: 0,
         })
     }
 
+    /// Attach a persistent, content-hash-keyed cache directory. Compilation
+    /// results are written there as serialized `CompiledGrammar` entries and
+    /// looked up before compiling, so a restarted process with a cold
+    /// in-memory cache can still serve repeat schemas from disk.
+    ///
+    /// Entries are namespaced by the tokenizer metadata and the engine
+    /// serialization version; stale or foreign entries are treated as cache
+    /// misses. The directory may be shared by concurrent processes.
+    ///
+    /// # Parameters
+    ///
+    /// - `dir`: The cache directory. Created if it does not exist.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the directory cannot be created.
+    pub fn set_persistent_cache_dir(
+        &mut self,
+        dir: impl AsRef<Path>,
+    ) -> Result<(), String> {
+        self.persistent_cache =
+            Some(PersistentCache::new(dir.as_ref(), &self.tokenizer_info)?);
+        Ok(())
+    }
+
+    /// The attached persistent cache directory, if any.
+    pub fn persistent_cache_dir(&self) -> Option<&Path> {
+        self.persistent_cache.as_ref().map(|c| c.root())
+    }
+
+    /// Looks up `key` in the persistent cache (if attached); on a miss, runs
+    /// `compile` and stores a successful result.
+    fn compile_through_persistent_cache(
+        &mut self,
+        key: u64,
+        compile: impl FnOnce(&mut Self) -> Result<CompiledGrammar, String>,
+    ) -> Result<CompiledGrammar, String> {
+        if let Some(cache) = &self.persistent_cache {
+            if let Some(hit) = cache.load(key, &self.tokenizer_info) {
+                return Ok(hit);
+            }
+        }
+        let compiled = compile(self)?;
+        if let Some(cache) = &self.persistent_cache {
+            cache.store(key, &compiled);
+        }
+        Ok(compiled)
+    }
+
     /// Get `CompiledGrammar` from the specified JSON schema and format. The indent
     /// and separators parameters follow the same convention as in `json.dumps()`.
     ///
@@ -90,7 +165,6 @@ impl GrammarCompiler {
         strict_mode: bool,
         max_whitespace_cnt: Option<i32>,
     ) -> Result<CompiledGrammar, String> {
-        cxx::let_cxx_string!(schema_cxx = schema);
         let has_indent = indent.is_some();
         let indent_i32: i32 = indent.unwrap_or(0);
         let has_separators = separators.is_some();
@@ -99,30 +173,223 @@ impl GrammarCompiler {
         } else {
             (String::new(), String::new())
         };
-        cxx::let_cxx_string!(sep_comma_cxx = sep_comma.as_str());
-        cxx::let_cxx_string!(sep_colon_cxx = sep_colon.as_str());
 
-        cxx::let_cxx_string!(error_out_cxx = "");
-        let unique_ptr = unsafe {
-            ffi::compiler_compile_json_schema(
-                self.inner.as_mut().expect("GrammarCompiler inner is null"),
-                &schema_cxx,
+        let key = Self::json_schema_key(
+            schema,
+            any_whitespace,
+            has_indent,
+            indent_i32,
+            has_separators,
+            &sep_comma,
+            &sep_colon,
+            strict_mode,
+            max_whitespace_cnt,
+        );
+        self.compile_through_persistent_cache(key, |this| {
+            cxx::let_cxx_string!(schema_cxx = schema);
+            cxx::let_cxx_string!(sep_comma_cxx = sep_comma.as_str());
+            cxx::let_cxx_string!(sep_colon_cxx = sep_colon.as_str());
+            cxx::let_cxx_string!(error_out_cxx = "");
+            let unique_ptr = unsafe {
+                ffi::coalescer_compile_json_schema(
+                    this.coalescer
+                        .as_mut()
+                        .expect("CompileCoalescer inner is null"),
+                    this.inner.as_mut().expect("GrammarCompiler inner is null"),
+                    key,
+                    &schema_cxx,
+                    any_whitespace,
+                    has_indent,
+                    indent_i32,
+                    has_separators,
+                    &sep_comma_cxx,
+                    &sep_colon_cxx,
+                    strict_mode,
+                    max_whitespace_cnt.is_some(),
+                    max_whitespace_cnt.unwrap_or(0),
+                    error_out_cxx.as_mut().get_unchecked_mut(),
+                )
+            };
+            if unique_ptr.is_null() {
+                return Err(error_out_cxx.to_string());
+            }
+            Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        })
+    }
+
+    /// The persistent-cache key for one JSON schema compilation.
+    #[allow(clippy::too_many_arguments)]
+    fn json_schema_key(
+        schema: &str,
+        any_whitespace: bool,
+        has_indent: bool,
+        indent_i32: i32,
+        has_separators: bool,
+        sep_comma: &str,
+        sep_colon: &str,
+        strict_mode: bool,
+        max_whitespace_cnt: Option<i32>,
+    ) -> u64 {
+        ContentHasher::new()
+            .write(b"json_schema")
+            .write(schema.as_bytes())
+            .write(&[
+                any_whitespace as u8,
+                has_indent as u8,
+                strict_mode as u8,
+                has_separators as u8,
+            ])
+            .write(&indent_i32.to_le_bytes())
+            .write(sep_comma.as_bytes())
+            .write(sep_colon.as_bytes())
+            .write(&max_whitespace_cnt.unwrap_or(-1).to_le_bytes())
+            .finish()
+    }
+
+    /// Compile multiple JSON schemas in one call, sharing the formatting
+    /// options across the batch. Up to `max_workers` submission threads
+    /// (`None` means the hardware concurrency) keep the compiler's thread
+    /// pool saturated across the whole batch, so warming many schemas costs
+    /// roughly the slowest schema times `N / workers` instead of the sum of
+    /// all schemas.
+    ///
+    /// If a persistent cache directory is attached, cached schemas are
+    /// served from disk and only the misses are compiled (and then stored).
+    ///
+    /// # Parameters
+    ///
+    /// - `schemas`: The schema strings.
+    /// - `max_workers`: The maximum number of concurrent submission threads.
+    ///
+    /// Other parameters are the same as `compile_json_schema` and apply to
+    /// every schema in the batch.
+    ///
+    /// # Returns
+    ///
+    /// One result per schema, in input order: the compiled grammar, or the
+    /// compilation error for that schema.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the batch itself cannot be run; per-schema
+    /// failures are reported in the returned entries instead.
+    #[allow(clippy::too_many_arguments)]
+    pub fn compile_json_schema_batch(
+        &mut self,
+        schemas: &[impl AsRef<str>],
+        any_whitespace: bool,
+        indent: Option<i32>,
+        separators: Option<(impl AsRef<str>, impl AsRef<str>)>,
+        strict_mode: bool,
+        max_whitespace_cnt: Option<i32>,
+        max_workers: Option<i32>,
+    ) -> Result<Vec<Result<CompiledGrammar, String>>, String> {
+        let has_indent = indent.is_some();
+        let indent_i32: i32 = indent.unwrap_or(0);
+        let has_separators = separators.is_some();
+        let (sep_comma, sep_colon) = if let Some((comma, colon)) = separators {
+            (comma.as_ref().to_string(), colon.as_ref().to_string())
+        } else {
+            (String::new(), String::new())
+        };
+
+        // Serve what we can from the persistent cache; only the misses are
+        // sent to the C++ batch.
+        let mut outcomes: Vec<Option<Result<CompiledGrammar, String>>> =
+            Vec::with_capacity(schemas.len());
+        let mut miss_indices: Vec<usize> = Vec::new();
+        let mut miss_keys: Vec<u64> = Vec::new();
+        for (i, schema) in schemas.iter().enumerate() {
+            let key = Self::json_schema_key(
+                schema.as_ref(),
                 any_whitespace,
                 has_indent,
                 indent_i32,
                 has_separators,
-                &sep_comma_cxx,
-                &sep_colon_cxx,
+                &sep_comma,
+                &sep_colon,
                 strict_mode,
-                max_whitespace_cnt.is_some(),
-                max_whitespace_cnt.unwrap_or(0),
-                error_out_cxx.as_mut().get_unchecked_mut(),
-            )
-        };
-        if unique_ptr.is_null() {
-            return Err(error_out_cxx.to_string());
+                max_whitespace_cnt,
+            );
+            let hit = self
+                .persistent_cache
+                .as_ref()
+                .and_then(|cache| cache.load(key, &self.tokenizer_info));
+            match hit {
+                Some(compiled) => outcomes.push(Some(Ok(compiled))),
+                None => {
+                    outcomes.push(None);
+                    miss_indices.push(i);
+                    miss_keys.push(key);
+                },
+            }
+        }
+
+        if !miss_indices.is_empty() {
+            let mut schemas_cxx = ffi::new_string_vector();
+            ffi::string_vec_reserve(schemas_cxx.pin_mut(), miss_indices.len());
+            for &i in &miss_indices {
+                let bytes = schemas[i].as_ref().as_bytes();
+                unsafe {
+                    ffi::string_vec_push_bytes(
+                        schemas_cxx.pin_mut(),
+                        bytes_as_c_char_ptr(bytes),
+                        bytes.len(),
+                    );
+                }
+            }
+            cxx::let_cxx_string!(sep_comma_cxx = sep_comma.as_str());
+            cxx::let_cxx_string!(sep_colon_cxx = sep_colon.as_str());
+            cxx::let_cxx_string!(error_out_cxx = "");
+            let mut batch = unsafe {
+                ffi::compiler_compile_json_schema_batch(
+                    self.inner.as_mut().expect("GrammarCompiler inner is null"),
+                    &schemas_cxx,
+                    any_whitespace,
+                    has_indent,
+                    indent_i32,
+                    has_separators,
+                    &sep_comma_cxx,
+                    &sep_colon_cxx,
+                    strict_mode,
+                    max_whitespace_cnt.is_some(),
+                    max_whitespace_cnt.unwrap_or(0),
+                    max_workers.unwrap_or(0),
+                    error_out_cxx.as_mut().get_unchecked_mut(),
+                )
+            };
+            if batch.is_null() {
+                return Err(error_out_cxx.to_string());
+            }
+            for (slot, (&i, &key)) in
+                miss_indices.iter().zip(&miss_keys).enumerate()
+            {
+                cxx::let_cxx_string!(entry_error_cxx = "");
+                let unique_ptr = unsafe {
+                    ffi::batch_compile_result_take(
+                        batch
+                            .as_mut()
+                            .expect("BatchCompileResult inner is null"),
+                        slot,
+                        entry_error_cxx.as_mut().get_unchecked_mut(),
+                    )
+                };
+                outcomes[i] = Some(if unique_ptr.is_null() {
+                    Err(entry_error_cxx.to_string())
+                } else {
+                    let compiled = CompiledGrammar::from_unique_ptr(unique_ptr);
+                    if let Some(cache) = &self.persistent_cache {
+                        cache.store(key, &compiled);
+                    }
+                    Ok(compiled)
+                });
+            }
         }
-        Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+
+        Ok(outcomes
+            .into_iter()
+            .map(|outcome| outcome.expect("every batch slot is filled"))
+            .collect())
     }
 
     /// Get `CompiledGrammar` from the standard JSON.
@@ -137,17 +404,20 @@ impl GrammarCompiler {
     pub fn compile_builtin_json_grammar(
         &mut self
     ) -> Result<CompiledGrammar, String> {
-        cxx::let_cxx_string!(error_out_cxx = "");
-        let unique_ptr = unsafe {
-            ffi::compiler_compile_builtin_json(
-                self.inner.as_mut().expect("GrammarCompiler inner is null"),
-                error_out_cxx.as_mut().get_unchecked_mut(),
-            )
-        };
-        if unique_ptr.is_null() {
-            return Err(error_out_cxx.to_string());
-        }
-        Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        let key = ContentHasher::new().write(b"builtin_json").finish();
+        self.compile_through_persistent_cache(key, |this| {
+            cxx::let_cxx_string!(error_out_cxx = "");
+            let unique_ptr = unsafe {
+                ffi::compiler_compile_builtin_json(
+                    this.inner.as_mut().expect("GrammarCompiler inner is null"),
+                    error_out_cxx.as_mut().get_unchecked_mut(),
+                )
+            };
+            if unique_ptr.is_null() {
+                return Err(error_out_cxx.to_string());
+            }
+            Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        })
     }
 
     /// Get `CompiledGrammar` from the specified regex.
@@ -167,24 +437,88 @@ impl GrammarCompiler {
         &mut self,
         regex: &str,
     ) -> Result<CompiledGrammar, String> {
-        cxx::let_cxx_string!(regex_cxx = regex);
-        cxx::let_cxx_string!(error_out_cxx = "");
-        let unique_ptr = unsafe {
-            ffi::compiler_compile_regex(
-                self.inner.as_mut().expect("GrammarCompiler inner is null"),
-                &regex_cxx,
-                error_out_cxx.as_mut().get_unchecked_mut(),
-            )
-        };
-        if unique_ptr.is_null() {
-            return Err(error_out_cxx.to_string());
+        let key = ContentHasher::new()
+            .write(b"regex")
+            .write(regex.as_bytes())
+            .finish();
+        self.compile_through_persistent_cache(key, |this| {
+            cxx::let_cxx_string!(regex_cxx = regex);
+            cxx::let_cxx_string!(error_out_cxx = "");
+            let unique_ptr = unsafe {
+                ffi::compiler_compile_regex(
+                    this.inner.as_mut().expect("GrammarCompiler inner is null"),
+                    &regex_cxx,
+                    error_out_cxx.as_mut().get_unchecked_mut(),
+                )
+            };
+            if unique_ptr.is_null() {
+                return Err(error_out_cxx.to_string());
+            }
+            Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        })
+    }
+
+    /// Get one `CompiledGrammar` matching any of the specified regexes.
+    ///
+    /// A routing layer matching output against many alternative formats
+    /// would otherwise compile one grammar and run one matcher per pattern;
+    /// this compiles the union of all patterns into a single automaton, so
+    /// one matcher and one bitmask row per sequence cover the whole set.
+    /// Identical patterns are deduplicated before the union, and the result
+    /// goes through the same caches as the other compile entry points.
+    ///
+    /// The matcher does not report which pattern accepted the output; when
+    /// the caller needs that, it can test the finalists individually with
+    /// `compile_regex`, whose results the compiler cache keeps warm.
+    ///
+    /// # Parameters
+    ///
+    /// - `patterns`: The regex strings; the set matches any of them.
+    ///
+    /// # Returns
+    ///
+    /// The compiled grammar matching the union of the patterns.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the set is empty, any pattern is invalid, or
+    /// compilation fails. The error names the offending pattern.
+    pub fn compile_regex_set(
+        &mut self,
+        patterns: &[impl AsRef<str>],
+    ) -> Result<CompiledGrammar, String> {
+        if patterns.is_empty() {
+            return Err(
+                "regex set must contain at least one pattern".to_string()
+            );
+        }
+        let mut grammars = Vec::with_capacity(patterns.len());
+        for pattern in patterns {
+            grammars.push(
+                grammar::Grammar::from_regex(pattern.as_ref(), false).map_err(
+                    |e| {
+                        format!(
+                            "invalid regex {:?} in regex set: {e}",
+                            pattern.as_ref()
+                        )
+                    },
+                )?,
+            );
         }
-        Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        let union = grammar::Grammar::union_deduped(&grammars);
+        self.compile_grammar(&union)
     }
 
     /// Compile a grammar from a structural tag. See the Structural Tag Usage in XGrammar
     /// documentation for its usage.
     ///
+    /// Compiled tag sets are cached in this compiler, keyed by a hash of the
+    /// individual tag items and the trigger list rather than the assembled
+    /// JSON, and independent of tag order. An agent that toggles tools
+    /// between turns therefore pays the full compilation once per distinct
+    /// tool subset; returning to any previously seen subset — in any tag
+    /// order — is a handle copy of the cached result.
+    ///
     /// # Parameters
     ///
     /// - `tags`: The structural tags.
@@ -202,6 +536,86 @@ impl GrammarCompiler {
         tags: &[StructuralTagItem],
         triggers: &[impl AsRef<str>],
     ) -> Result<CompiledGrammar, String> {
+        let key = Self::structural_tag_key(tags, triggers);
+        if let Some(position) = self
+            .structural_tag_cache
+            .iter()
+            .position(|(cached_key, _)| *cached_key == key)
+        {
+            let entry = self.structural_tag_cache.remove(position);
+            let compiled = entry.1.clone_handle();
+            self.structural_tag_cache.push(entry);
+            self.structural_tag_cache_hits += 1;
+            return Ok(compiled);
+        }
+
+        let structural_tag_json = Self::structural_tag_to_json(tags, triggers)?;
+        let compiled = self.compile_through_persistent_cache(key, |this| {
+            cxx::let_cxx_string!(structural_tag_str = structural_tag_json);
+            cxx::let_cxx_string!(error_out_cxx = "");
+            let unique_ptr = unsafe {
+                ffi::compiler_compile_structural_tag(
+                    this.inner.as_mut().expect("GrammarCompiler inner is null"),
+                    &structural_tag_str,
+                    error_out_cxx.as_mut().get_unchecked_mut(),
+                )
+            };
+            if unique_ptr.is_null() {
+                return Err(error_out_cxx.to_string());
+            }
+            Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        })?;
+
+        if self.structural_tag_cache.len() >= STRUCTURAL_TAG_CACHE_CAP {
+            self.structural_tag_cache.remove(0);
+        }
+        self.structural_tag_cache.push((key, compiled.clone_handle()));
+        Ok(compiled)
+    }
+
+    /// The number of `compile_structural_tag` calls served from the in-memory
+    /// tag-set cache.
+    pub fn structural_tag_cache_hits(&self) -> u64 {
+        self.structural_tag_cache_hits
+    }
+
+    /// Content key of a structural tag set: each tag item is hashed on its
+    /// own and the per-tag hashes are sorted before being combined, so the
+    /// key is independent of tag order (tag dispatch selects by begin text,
+    /// not position) and computing it is linear in the catalog size. The
+    /// trigger list is hashed in order.
+    fn structural_tag_key(
+        tags: &[StructuralTagItem],
+        triggers: &[impl AsRef<str>],
+    ) -> u64 {
+        let mut tag_hashes: Vec<u64> = tags
+            .iter()
+            .map(|tag| {
+                ContentHasher::new()
+                    .write(tag.begin.as_bytes())
+                    .write(tag.schema.as_bytes())
+                    .write(tag.end.as_bytes())
+                    .finish()
+            })
+            .collect();
+        tag_hashes.sort_unstable();
+        let mut hasher = ContentHasher::new();
+        hasher.write(b"structural_tag");
+        for tag_hash in tag_hashes {
+            hasher.write(&tag_hash.to_le_bytes());
+        }
+        for trigger in triggers {
+            hasher.write(trigger.as_ref().as_bytes());
+        }
+        hasher.finish()
+    }
+
+    /// Build the structural-tag JSON accepted by the engine from tags and
+    /// triggers.
+    fn structural_tag_to_json(
+        tags: &[StructuralTagItem],
+        triggers: &[impl AsRef<str>],
+    ) -> Result<String, String> {
         use serde_json::json;
         let mut tag_entries = Vec::new();
         for tag in tags {
@@ -227,25 +641,11 @@ impl GrammarCompiler {
             "triggers": triggers_vec,
             "tags": tag_entries,
         });
-        let structural_tag_json = json!({
+        Ok(json!({
             "type": "structural_tag",
             "format": format_obj,
         })
-        .to_string();
-
-        cxx::let_cxx_string!(structural_tag_str = structural_tag_json);
-        cxx::let_cxx_string!(error_out_cxx = "");
-        let unique_ptr = unsafe {
-            ffi::compiler_compile_structural_tag(
-                self.inner.as_mut().expect("GrammarCompiler inner is null"),
-                &structural_tag_str,
-                error_out_cxx.as_mut().get_unchecked_mut(),
-            )
-        };
-        if unique_ptr.is_null() {
-            return Err(error_out_cxx.to_string());
-        }
-        Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        .to_string())
     }
 
     /// Compile a grammar object.
@@ -265,18 +665,29 @@ impl GrammarCompiler {
         &mut self,
         grammar: &grammar::Grammar,
     ) -> Result<CompiledGrammar, String> {
-        cxx::let_cxx_string!(error_out_cxx = "");
-        let unique_ptr = unsafe {
-            ffi::compiler_compile_grammar_or_error(
-                self.inner.as_mut().expect("GrammarCompiler inner is null"),
-                grammar.ffi_ref(),
-                error_out_cxx.as_mut().get_unchecked_mut(),
-            )
+        // Hashing the serialized grammar is cheap relative to compilation,
+        // and only done when a persistent cache is attached.
+        let key = match &self.persistent_cache {
+            Some(_) => ContentHasher::new()
+                .write(b"grammar")
+                .write(grammar.serialize_json().as_bytes())
+                .finish(),
+            None => 0,
         };
-        if unique_ptr.is_null() {
-            return Err(error_out_cxx.to_string());
-        }
-        Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        self.compile_through_persistent_cache(key, |this| {
+            cxx::let_cxx_string!(error_out_cxx = "");
+            let unique_ptr = unsafe {
+                ffi::compiler_compile_grammar_or_error(
+                    this.inner.as_mut().expect("GrammarCompiler inner is null"),
+                    grammar.ffi_ref(),
+                    error_out_cxx.as_mut().get_unchecked_mut(),
+                )
+            };
+            if unique_ptr.is_null() {
+                return Err(error_out_cxx.to_string());
+            }
+            Ok(CompiledGrammar::from_unique_ptr(unique_ptr))
+        })
     }
 
     /// Compile a grammar from an EBNF string. The string should follow the format described in
@@ -303,6 +714,218 @@ impl GrammarCompiler {
         self.compile_grammar(&grammar)
     }
 
+    /// Start compiling the specified JSON schema on a background thread.
+    /// Parameters are the same as `compile_json_schema`.
+    ///
+    /// The returned future can be polled with `is_ready` and claimed with
+    /// `wait`, so compilation overlaps with other work instead of blocking
+    /// the calling thread. The background compilation shares this compiler's
+    /// thread pool and in-memory cache; the persistent disk cache is not
+    /// consulted on the async path. Concurrent compilations of the same
+    /// schema are coalesced into one (see `coalesced_compile_waits`).
+    ///
+    /// # Returns
+    ///
+    /// A future resolving to the compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the compilation cannot be started. Errors from the
+    /// compilation itself are reported by `CompileFuture::wait`.
+    pub fn compile_json_schema_async(
+        &mut self,
+        schema: &str,
+        any_whitespace: bool,
+        indent: Option<i32>,
+        separators: Option<(impl AsRef<str>, impl AsRef<str>)>,
+        strict_mode: bool,
+        max_whitespace_cnt: Option<i32>,
+    ) -> Result<CompileFuture, String> {
+        let has_indent = indent.is_some();
+        let indent_i32: i32 = indent.unwrap_or(0);
+        let has_separators = separators.is_some();
+        let (sep_comma, sep_colon) = if let Some((comma, colon)) = separators {
+            (comma.as_ref().to_string(), colon.as_ref().to_string())
+        } else {
+            (String::new(), String::new())
+        };
+        let key = Self::json_schema_key(
+            schema,
+            any_whitespace,
+            has_indent,
+            indent_i32,
+            has_separators,
+            &sep_comma,
+            &sep_colon,
+            strict_mode,
+            max_whitespace_cnt,
+        );
+        cxx::let_cxx_string!(schema_cxx = schema);
+        cxx::let_cxx_string!(sep_comma_cxx = sep_comma.as_str());
+        cxx::let_cxx_string!(sep_colon_cxx = sep_colon.as_str());
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let unique_ptr = unsafe {
+            ffi::coalescer_compile_json_schema_async(
+                self.coalescer
+                    .as_mut()
+                    .expect("CompileCoalescer inner is null"),
+                self.inner.as_mut().expect("GrammarCompiler inner is null"),
+                key,
+                &schema_cxx,
+                any_whitespace,
+                has_indent,
+                indent_i32,
+                has_separators,
+                &sep_comma_cxx,
+                &sep_colon_cxx,
+                strict_mode,
+                max_whitespace_cnt.is_some(),
+                max_whitespace_cnt.unwrap_or(0),
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if unique_ptr.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(CompileFuture::from_unique_ptr(unique_ptr))
+    }
+
+    /// Start compiling the standard JSON grammar on a background thread. See
+    /// `compile_json_schema_async` for the future semantics.
+    ///
+    /// # Returns
+    ///
+    /// A future resolving to the compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the compilation cannot be started.
+    pub fn compile_builtin_json_grammar_async(
+        &mut self
+    ) -> Result<CompileFuture, String> {
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let unique_ptr = unsafe {
+            ffi::compiler_compile_builtin_json_async(
+                self.inner.as_mut().expect("GrammarCompiler inner is null"),
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if unique_ptr.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(CompileFuture::from_unique_ptr(unique_ptr))
+    }
+
+    /// Start compiling the specified regex on a background thread. See
+    /// `compile_json_schema_async` for the future semantics.
+    ///
+    /// # Parameters
+    ///
+    /// - `regex`: The regex string.
+    ///
+    /// # Returns
+    ///
+    /// A future resolving to the compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the compilation cannot be started.
+    pub fn compile_regex_async(
+        &mut self,
+        regex: &str,
+    ) -> Result<CompileFuture, String> {
+        cxx::let_cxx_string!(regex_cxx = regex);
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let unique_ptr = unsafe {
+            ffi::compiler_compile_regex_async(
+                self.inner.as_mut().expect("GrammarCompiler inner is null"),
+                &regex_cxx,
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if unique_ptr.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(CompileFuture::from_unique_ptr(unique_ptr))
+    }
+
+    /// Start compiling a structural tag on a background thread. Parameters
+    /// are the same as `compile_structural_tag`; see
+    /// `compile_json_schema_async` for the future semantics.
+    ///
+    /// # Returns
+    ///
+    /// A future resolving to the compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the structural tag is invalid or the compilation
+    /// cannot be started.
+    pub fn compile_structural_tag_async(
+        &mut self,
+        tags: &[StructuralTagItem],
+        triggers: &[impl AsRef<str>],
+    ) -> Result<CompileFuture, String> {
+        let structural_tag_json = Self::structural_tag_to_json(tags, triggers)?;
+        cxx::let_cxx_string!(structural_tag_str = structural_tag_json);
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let unique_ptr = unsafe {
+            ffi::compiler_compile_structural_tag_async(
+                self.inner.as_mut().expect("GrammarCompiler inner is null"),
+                &structural_tag_str,
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if unique_ptr.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(CompileFuture::from_unique_ptr(unique_ptr))
+    }
+
+    /// Start compiling a grammar object on a background thread. See
+    /// `compile_json_schema_async` for the future semantics.
+    ///
+    /// # Parameters
+    ///
+    /// - `grammar`: The grammar object.
+    ///
+    /// # Returns
+    ///
+    /// A future resolving to the compiled grammar.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the compilation cannot be started.
+    pub fn compile_grammar_async(
+        &mut self,
+        grammar: &grammar::Grammar,
+    ) -> Result<CompileFuture, String> {
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let unique_ptr = unsafe {
+            ffi::compiler_compile_grammar_async(
+                self.inner.as_mut().expect("GrammarCompiler inner is null"),
+                grammar.ffi_ref(),
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if unique_ptr.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(CompileFuture::from_unique_ptr(unique_ptr))
+    }
+
+    /// How many compile requests joined an in-flight compilation of the
+    /// same JSON schema instead of starting their own. Concurrent requests
+    /// for the same uncached schema (through `compile_json_schema` and
+    /// `compile_json_schema_async`) are coalesced: the first one compiles,
+    /// the rest wait for its result. The counter is useful for verifying
+    /// that a post-deploy thundering herd collapsed into one compilation.
+    pub fn coalesced_compile_waits(&self) -> u64 {
+        ffi::coalescer_coalesced_waits(
+            self.coalescer.as_ref().expect("CompileCoalescer inner is null"),
+        )
+    }
+
     /// Clear all cached compiled grammars.
     pub fn clear_cache(&mut self) {
         self.inner
@@ -1,7 +1,14 @@
 //! Compiling grammar for efficient token mask generation.
 
+pub mod compile_future;
 pub mod compiled_grammar;
 pub mod grammar_compiler;
+mod persistent_cache;
 
-pub use compiled_grammar::CompiledGrammar;
+pub(crate) use persistent_cache::ContentHasher;
+
+pub use compile_future::CompileFuture;
+pub use compiled_grammar::{
+    CompiledGrammar, live_compiled_grammar_bytes, live_compiled_grammar_count,
+};
 pub use grammar_compiler::GrammarCompiler;
@@ -0,0 +1,121 @@
+//! Content-addressed on-disk cache for compiled grammars.
+//!
+//! The in-memory compiler cache dies with the process; this cache lets a
+//! restarted worker reuse compilation results from previous runs. Entries are
+//! keyed by a stable content hash of the compilation inputs plus the
+//! tokenizer metadata, and namespaced by the engine serialization version, so
+//! incompatible entries from older builds are simply never looked up. Loads
+//! are additionally validated by the engine's own metadata and version checks
+//! during deserialization; any mismatch is treated as a cache miss.
+
+use std::{
+    fs,
+    path::{Path, PathBuf},
+};
+
+use crate::{CompiledGrammar, TokenizerInfo, get_serialization_version};
+
+/// FNV-1a, used for cache keys because it is stable across processes and
+/// toolchain versions (unlike `DefaultHasher`). Collisions are harmless: the
+/// engine rejects mismatched entries during deserialization.
+pub(crate) struct ContentHasher {
+    state: u64,
+}
+
+impl ContentHasher {
+    pub(crate) fn new() -> Self {
+        Self {
+            state: 0xcbf2_9ce4_8422_2325,
+        }
+    }
+
+    pub(crate) fn write(
+        &mut self,
+        bytes: &[u8],
+    ) -> &mut Self {
+        for &b in bytes {
+            self.state ^= u64::from(b);
+            self.state = self.state.wrapping_mul(0x0000_0100_0000_01b3);
+        }
+        // Separator byte so adjacent fields cannot alias each other.
+        self.state ^= 0xff;
+        self.state = self.state.wrapping_mul(0x0000_0100_0000_01b3);
+        self
+    }
+
+    pub(crate) fn finish(&self) -> u64 {
+        self.state
+    }
+}
+
+/// A persistent, content-hash-keyed cache directory for `CompiledGrammar`.
+///
+/// Stores one file per entry, written atomically (temp file + rename), so a
+/// directory can be shared by concurrent workers. All I/O failures during
+/// lookup and store are treated as cache misses; the cache never makes a
+/// compilation fail.
+pub(crate) struct PersistentCache {
+    root: PathBuf,
+    tokenizer_key: u64,
+    version: String,
+}
+
+impl PersistentCache {
+    pub(crate) fn new(
+        root: &Path,
+        tokenizer_info: &TokenizerInfo,
+    ) -> Result<Self, String> {
+        fs::create_dir_all(root).map_err(|e| {
+            format!(
+                "failed to create persistent cache dir {}: {e}",
+                root.display()
+            )
+        })?;
+        let tokenizer_key = ContentHasher::new()
+            .write(tokenizer_info.dump_metadata().as_bytes())
+            .finish();
+        Ok(Self {
+            root: root.to_path_buf(),
+            tokenizer_key,
+            version: get_serialization_version(),
+        })
+    }
+
+    pub(crate) fn root(&self) -> &Path {
+        &self.root
+    }
+
+    fn entry_path(
+        &self,
+        key: u64,
+    ) -> PathBuf {
+        self.root.join(format!(
+            "{:016x}-{key:016x}.{}.json",
+            self.tokenizer_key, self.version
+        ))
+    }
+
+    pub(crate) fn load(
+        &self,
+        key: u64,
+        tokenizer_info: &TokenizerInfo,
+    ) -> Option<CompiledGrammar> {
+        let json = fs::read_to_string(self.entry_path(key)).ok()?;
+        CompiledGrammar::deserialize_json(&json, tokenizer_info).ok()
+    }
+
+    pub(crate) fn store(
+        &self,
+        key: u64,
+        compiled: &CompiledGrammar,
+    ) {
+        let path = self.entry_path(key);
+        // Per-process temp name so concurrent workers sharing the directory
+        // never clobber each other's partially written entries.
+        let tmp = path.with_extension(format!("tmp{}", std::process::id()));
+        let json = compiled.serialize_json();
+        if fs::write(&tmp, json).is_ok() {
+            let _ = fs::rename(&tmp, &path);
+        }
+    }
+}
@@ -1,12 +1,19 @@
 #ifndef XGRAMMAR_RS_CXX_UTILS_H_
 #define XGRAMMAR_RS_CXX_UTILS_H_
 
+#include "cxx_utils/status.hpp"
 #include "cxx_utils/string_vec.hpp"
 #include "cxx_utils/tokenizer_info.hpp"
+#include "cxx_utils/tokenizer_registry.hpp"
 #include "cxx_utils/grammar.hpp"
 #include "cxx_utils/compiled_grammar.hpp"
 #include "cxx_utils/grammar_compiler.hpp"
+#include "cxx_utils/compile_future.hpp"
+#include "cxx_utils/coalesce.hpp"
+#include "cxx_utils/batch_compile.hpp"
 #include "cxx_utils/matcher.hpp"
+#include "cxx_utils/matcher_pipeline.hpp"
 #include "cxx_utils/config.hpp"
+#include "cxx_utils/bench.hpp"
 
 #endif // XGRAMMAR_RS_CXX_UTILS_H_
@@ -0,0 +1,169 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_BATCH_COMPILE_H_
+#define XGRAMMAR_RS_CXX_UTILS_BATCH_COMPILE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "xgrammar/xgrammar.h"
+
+#include "common.hpp"
+#include "compile_future.hpp"
+
+namespace cxx_utils {
+
+// Opaque container for the per-schema outcomes of one batch compilation.
+// Each slot is claimed at most once via `batch_compile_result_take`.
+class BatchCompileResult {
+ public:
+  explicit BatchCompileResult(std::vector<CompileResult>&& results)
+      : results_(std::move(results)) {}
+
+  size_t size() const { return results_.size(); }
+
+  bool is_ok(size_t index) const {
+    return index < results_.size() && results_[index].compiled != nullptr;
+  }
+
+  std::unique_ptr<xgrammar::CompiledGrammar> take(
+      size_t index,
+      std::string* error_out
+  ) {
+    if (error_out) {
+      error_out->clear();
+    }
+    if (index >= results_.size()) {
+      if (error_out) {
+        *error_out = "batch compile result index out of range";
+      }
+      return nullptr;
+    }
+    CompileResult& result = results_[index];
+    if (!result.compiled) {
+      if (error_out) {
+        *error_out = result.error.empty()
+                         ? "batch compile result was already taken"
+                         : result.error;
+      }
+      return nullptr;
+    }
+    return std::move(result.compiled);
+  }
+
+ private:
+  std::vector<CompileResult> results_;
+};
+
+// Compiles all `schemas` with the shared options before returning, keeping
+// up to `max_workers` submission threads (<= 0 means hardware concurrency)
+// pulling schemas from a shared queue. Each worker holds its own copy of the
+// compiler handle, so all workers share the compiler's cache, and per-schema
+// failures land in the corresponding result slot instead of aborting the
+// batch.
+inline std::unique_ptr<BatchCompileResult> compiler_compile_json_schema_batch(
+    xgrammar::GrammarCompiler& compiler,
+    const std::vector<std::string>& schemas,
+    bool any_whitespace,
+    bool has_indent,
+    int32_t indent,
+    bool has_separators,
+    const std::string& separator_comma,
+    const std::string& separator_colon,
+    bool strict_mode,
+    bool has_max_whitespace_cnt,
+    int32_t max_whitespace_cnt,
+    int32_t max_workers,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+    std::optional<int> indent_opt =
+        has_indent ? std::optional<int>(indent) : std::nullopt;
+    std::optional<std::pair<std::string, std::string>> sep_opt =
+        has_separators ? std::optional<std::pair<std::string, std::string>>(
+                             std::make_pair(separator_comma, separator_colon)
+                         )
+                       : std::nullopt;
+    std::optional<int> max_whitespace_cnt_opt =
+        has_max_whitespace_cnt ? std::optional<int>(max_whitespace_cnt)
+                               : std::nullopt;
+
+    std::vector<CompileResult> results(schemas.size());
+    size_t num_workers = max_workers > 0
+                             ? static_cast<size_t>(max_workers)
+                             : static_cast<size_t>(
+                                   std::thread::hardware_concurrency()
+                               );
+    if (num_workers == 0) {
+      num_workers = 1;
+    }
+    if (num_workers > schemas.size()) {
+      num_workers = schemas.size();
+    }
+
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+      // Handle copy: shares the compiler's thread pool and cache.
+      xgrammar::GrammarCompiler compiler_copy = compiler;
+      while (true) {
+        size_t i = next_index.fetch_add(1);
+        if (i >= schemas.size()) {
+          break;
+        }
+        try {
+          results[i].compiled = make_unique(compiler_copy.CompileJSONSchema(
+              schemas[i],
+              any_whitespace,
+              indent_opt,
+              sep_opt,
+              strict_mode,
+              max_whitespace_cnt_opt
+          ));
+        } catch (const std::exception& e) {
+          results[i].error = e.what();
+        } catch (...) {
+          results[i].error = "unknown C++ exception";
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+      threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return std::make_unique<BatchCompileResult>(std::move(results));
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
+inline std::unique_ptr<xgrammar::CompiledGrammar> batch_compile_result_take(
+    BatchCompileResult& result,
+    size_t index,
+    std::string* error_out
+) {
+  return result.take(index, error_out);
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_BATCH_COMPILE_H_
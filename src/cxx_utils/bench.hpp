@@ -0,0 +1,33 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_BENCH_H_
+#define XGRAMMAR_RS_CXX_UTILS_BENCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cxx_utils {
+
+// No-op entry points mirroring the calling conventions of the hot glue
+// functions, so the benchmark suite can measure the cost of an FFI crossing
+// by itself and subtract it from end-to-end numbers. `bench_ffi_noop_status`
+// goes through the same raw-pointer-arguments + `error_out` convention as
+// the matcher entry points without doing any work.
+
+inline void bench_ffi_noop() {}
+
+inline bool bench_ffi_noop_status(
+    const int32_t* values_ptr,
+    size_t values_len,
+    std::string* error_out
+) {
+  (void)values_ptr;
+  (void)values_len;
+  if (error_out) {
+    error_out->clear();
+  }
+  return true;
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_BENCH_H_
@@ -0,0 +1,375 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_BITMASK_KERNELS_H_
+#define XGRAMMAR_RS_CXX_UTILS_BITMASK_KERNELS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "dlpack/dlpack.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XGRAMMAR_RS_BITMASK_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define XGRAMMAR_RS_BITMASK_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__wasm_simd128__)
+#define XGRAMMAR_RS_BITMASK_WASM_SIMD 1
+#include <wasm_simd128.h>
+#endif
+
+namespace cxx_utils {
+namespace bitmask_kernels {
+
+// -inf bit patterns for the 16-bit float formats. Masked-out logits are
+// overwritten with these raw constants, so no f16/bf16 arithmetic is needed.
+inline constexpr uint16_t kNegInfF16Bits = 0xFC00;
+inline constexpr uint16_t kNegInfBf16Bits = 0xFF80;
+
+inline bool is_f32(const DLDataType& dt) {
+  return dt.code == kDLFloat && dt.bits == 32 && dt.lanes == 1;
+}
+
+inline bool is_f16(const DLDataType& dt) {
+  return dt.code == kDLFloat && dt.bits == 16 && dt.lanes == 1;
+}
+
+inline bool is_bf16(const DLDataType& dt) {
+  return dt.code == kDLBfloat && dt.bits == 16 && dt.lanes == 1;
+}
+
+/**
+ * Scalar fallback for one row of f32 logits: word-skipping, so fully-allowed
+ * mask words (-1, the common case) cost one compare per 32 logits.
+ */
+inline void apply_mask_row_f32_scalar(
+    float* row,
+    const int32_t* mask_words,
+    int64_t vocab_size
+) {
+  for (int64_t word = 0; word * 32 < vocab_size; ++word) {
+    int32_t m = mask_words[word];
+    if (m == -1) {
+      continue;
+    }
+    int64_t base = word * 32;
+    int64_t limit = std::min<int64_t>(32, vocab_size - base);
+    for (int64_t bit = 0; bit < limit; ++bit) {
+      if ((m & (1 << bit)) == 0) {
+        row[base + bit] = -std::numeric_limits<float>::infinity();
+      }
+    }
+  }
+}
+
+/**
+ * One row of 16-bit logits (f16 or bf16): stores the given -inf bit pattern
+ * at every masked-out position. Store-only, so bandwidth is bounded by the
+ * number of masked positions, not the vocab size.
+ */
+inline void apply_mask_row_u16_scalar(
+    uint16_t* row,
+    const int32_t* mask_words,
+    int64_t vocab_size,
+    uint16_t neg_inf_bits
+) {
+  for (int64_t word = 0; word * 32 < vocab_size; ++word) {
+    int32_t m = mask_words[word];
+    if (m == -1) {
+      continue;
+    }
+    int64_t base = word * 32;
+    int64_t limit = std::min<int64_t>(32, vocab_size - base);
+    if (m == 0 && limit == 32) {
+      std::fill(row + base, row + base + 32, neg_inf_bits);
+      continue;
+    }
+    for (int64_t bit = 0; bit < limit; ++bit) {
+      if ((m & (1 << bit)) == 0) {
+        row[base + bit] = neg_inf_bits;
+      }
+    }
+  }
+}
+
+#if defined(XGRAMMAR_RS_BITMASK_X86)
+
+inline bool x86_has_avx2() {
+  static const bool has = __builtin_cpu_supports("avx2");
+  return has;
+}
+
+__attribute__((target("avx2"))) inline void apply_mask_row_f32_avx2(
+    float* row,
+    const int32_t* mask_words,
+    int64_t vocab_size
+) {
+  const __m256i bit_select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  const __m256 neg_inf =
+      _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+  int64_t word = 0;
+  for (; (word + 1) * 32 <= vocab_size; ++word) {
+    int32_t m = mask_words[word];
+    if (m == -1) {
+      continue;
+    }
+    float* chunk = row + word * 32;
+    for (int group = 0; group < 4; ++group) {
+      int32_t g = (m >> (group * 8)) & 0xFF;
+      if (g == 0xFF) {
+        continue;
+      }
+      __m256i vm = _mm256_set1_epi32(g);
+      __m256i keep = _mm256_cmpeq_epi32(
+          _mm256_and_si256(vm, bit_select),
+          bit_select
+      );
+      float* p = chunk + group * 8;
+      __m256 cur = _mm256_loadu_ps(p);
+      __m256 res =
+          _mm256_blendv_ps(neg_inf, cur, _mm256_castsi256_ps(keep));
+      _mm256_storeu_ps(p, res);
+    }
+  }
+  // Scalar tail for a partial final word.
+  if (word * 32 < vocab_size) {
+    apply_mask_row_f32_scalar(
+        row + word * 32,
+        mask_words + word,
+        vocab_size - word * 32
+    );
+  }
+}
+
+#endif // XGRAMMAR_RS_BITMASK_X86
+
+#if defined(XGRAMMAR_RS_BITMASK_NEON)
+
+inline void apply_mask_row_f32_neon(
+    float* row,
+    const int32_t* mask_words,
+    int64_t vocab_size
+) {
+  const uint32x4_t bit_select = {1, 2, 4, 8};
+  const float32x4_t neg_inf =
+      vdupq_n_f32(-std::numeric_limits<float>::infinity());
+  int64_t word = 0;
+  for (; (word + 1) * 32 <= vocab_size; ++word) {
+    int32_t m = mask_words[word];
+    if (m == -1) {
+      continue;
+    }
+    float* chunk = row + word * 32;
+    for (int group = 0; group < 8; ++group) {
+      uint32_t g = (static_cast<uint32_t>(m) >> (group * 4)) & 0xF;
+      if (g == 0xF) {
+        continue;
+      }
+      uint32x4_t vm = vdupq_n_u32(g);
+      uint32x4_t keep = vceqq_u32(vandq_u32(vm, bit_select), bit_select);
+      float* p = chunk + group * 4;
+      float32x4_t cur = vld1q_f32(p);
+      float32x4_t res = vbslq_f32(keep, cur, neg_inf);
+      vst1q_f32(p, res);
+    }
+  }
+  if (word * 32 < vocab_size) {
+    apply_mask_row_f32_scalar(
+        row + word * 32,
+        mask_words + word,
+        vocab_size - word * 32
+    );
+  }
+}
+
+#endif // XGRAMMAR_RS_BITMASK_NEON
+
+#if defined(XGRAMMAR_RS_BITMASK_WASM_SIMD)
+
+inline void apply_mask_row_f32_wasm_simd(
+    float* row,
+    const int32_t* mask_words,
+    int64_t vocab_size
+) {
+  const v128_t bit_select = wasm_i32x4_make(1, 2, 4, 8);
+  const v128_t neg_inf =
+      wasm_f32x4_splat(-std::numeric_limits<float>::infinity());
+  int64_t word = 0;
+  for (; (word + 1) * 32 <= vocab_size; ++word) {
+    int32_t m = mask_words[word];
+    if (m == -1) {
+      continue;
+    }
+    float* chunk = row + word * 32;
+    for (int group = 0; group < 8; ++group) {
+      int32_t g = (m >> (group * 4)) & 0xF;
+      if (g == 0xF) {
+        continue;
+      }
+      v128_t vm = wasm_i32x4_splat(g);
+      v128_t keep = wasm_i32x4_eq(wasm_v128_and(vm, bit_select), bit_select);
+      float* p = chunk + group * 4;
+      v128_t cur = wasm_v128_load(p);
+      v128_t res = wasm_v128_bitselect(cur, neg_inf, keep);
+      wasm_v128_store(p, res);
+    }
+  }
+  if (word * 32 < vocab_size) {
+    apply_mask_row_f32_scalar(
+        row + word * 32,
+        mask_words + word,
+        vocab_size - word * 32
+    );
+  }
+}
+
+#endif // XGRAMMAR_RS_BITMASK_WASM_SIMD
+
+/** Applies one bitmask row to one f32 logits row, picking the widest
+ * instruction set available at runtime. */
+inline void apply_mask_row_f32(
+    float* row,
+    const int32_t* mask_words,
+    int64_t vocab_size
+) {
+#if defined(XGRAMMAR_RS_BITMASK_X86)
+  if (x86_has_avx2()) {
+    apply_mask_row_f32_avx2(row, mask_words, vocab_size);
+    return;
+  }
+#elif defined(XGRAMMAR_RS_BITMASK_NEON)
+  apply_mask_row_f32_neon(row, mask_words, vocab_size);
+  return;
+#elif defined(XGRAMMAR_RS_BITMASK_WASM_SIMD)
+  apply_mask_row_f32_wasm_simd(row, mask_words, vocab_size);
+  return;
+#endif
+  apply_mask_row_f32_scalar(row, mask_words, vocab_size);
+}
+
+struct TensorView2D {
+  char* data;
+  int64_t rows;
+  int64_t cols;
+  int64_t row_stride; // in elements
+};
+
+/**
+ * Views a 1D or 2D CPU tensor whose innermost dimension is contiguous as a
+ * row-major matrix. Returns false for layouts the fast path does not handle.
+ */
+inline bool view_rows(const DLTensor* t, TensorView2D* out) {
+  if (t == nullptr || t->data == nullptr ||
+      t->device.device_type != kDLCPU) {
+    return false;
+  }
+  if (t->ndim == 1) {
+    if (t->strides != nullptr && t->strides[0] != 1) {
+      return false;
+    }
+    out->rows = 1;
+    out->cols = t->shape[0];
+    out->row_stride = t->shape[0];
+  } else if (t->ndim == 2) {
+    if (t->strides != nullptr && t->strides[1] != 1) {
+      return false;
+    }
+    out->rows = t->shape[0];
+    out->cols = t->shape[1];
+    out->row_stride =
+        t->strides != nullptr ? t->strides[0] : t->shape[1];
+  } else {
+    return false;
+  }
+  out->data = static_cast<char*>(t->data) + t->byte_offset;
+  return out->rows >= 0 && out->cols >= 0;
+}
+
+/**
+ * Vectorized ApplyTokenBitmaskInplaceCPU covering f32/f16/bf16 logits on 1D
+ * or 2D CPU tensors with a contiguous innermost dimension. Returns false if
+ * the layout or dtype is not handled, in which case the caller should fall
+ * back to the engine implementation (which also produces the proper error
+ * for genuinely invalid inputs).
+ */
+inline bool apply_token_bitmask_fast_path(
+    DLTensor* logits,
+    const DLTensor* bitmask,
+    int32_t vocab_size,
+    const int32_t* indices_ptr,
+    size_t indices_len
+) {
+  const DLDataType& dt = logits->dtype;
+  if (!is_f32(dt) && !is_f16(dt) && !is_bf16(dt)) {
+    return false;
+  }
+  if (bitmask->dtype.code != kDLInt || bitmask->dtype.bits != 32 ||
+      bitmask->dtype.lanes != 1) {
+    return false;
+  }
+
+  TensorView2D logits_view;
+  TensorView2D bitmask_view;
+  if (!view_rows(logits, &logits_view) ||
+      !view_rows(bitmask, &bitmask_view)) {
+    return false;
+  }
+
+  int64_t effective_vocab = vocab_size > 0
+      ? vocab_size
+      : std::min<int64_t>(logits_view.cols, bitmask_view.cols * 32);
+  if (effective_vocab > logits_view.cols ||
+      effective_vocab > bitmask_view.cols * 32) {
+    return false;
+  }
+
+  int64_t shared_rows = std::min(logits_view.rows, bitmask_view.rows);
+  if (indices_ptr != nullptr) {
+    for (size_t i = 0; i < indices_len; ++i) {
+      if (indices_ptr[i] < 0 || indices_ptr[i] >= shared_rows) {
+        return false;
+      }
+    }
+  }
+
+  size_t num_rows = indices_ptr != nullptr
+      ? indices_len
+      : static_cast<size_t>(shared_rows);
+  size_t elem_size = dt.bits / 8;
+  for (size_t i = 0; i < num_rows; ++i) {
+    int64_t row = indices_ptr != nullptr ? indices_ptr[i]
+                                         : static_cast<int64_t>(i);
+    char* logits_row =
+        logits_view.data + row * logits_view.row_stride * elem_size;
+    const int32_t* mask_row = reinterpret_cast<const int32_t*>(
+        bitmask_view.data + row * bitmask_view.row_stride * sizeof(int32_t)
+    );
+    if (is_f32(dt)) {
+      apply_mask_row_f32(
+          reinterpret_cast<float*>(logits_row),
+          mask_row,
+          effective_vocab
+      );
+    } else {
+      apply_mask_row_u16_scalar(
+          reinterpret_cast<uint16_t*>(logits_row),
+          mask_row,
+          effective_vocab,
+          is_f16(dt) ? kNegInfF16Bits : kNegInfBf16Bits
+      );
+    }
+  }
+  return true;
+}
+
+} // namespace bitmask_kernels
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_BITMASK_KERNELS_H_
@@ -0,0 +1,234 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_COALESCE_H_
+#define XGRAMMAR_RS_CXX_UTILS_COALESCE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "xgrammar/xgrammar.h"
+
+#include "common.hpp"
+#include "compile_future.hpp"
+
+namespace cxx_utils {
+
+// Result of one coalesced compilation. Unlike `CompileResult`, it is
+// copyable (the compiled grammar is a cheap shared-state handle), so every
+// waiter on a shared future can take its own copy.
+struct SharedCompileResult {
+  std::optional<xgrammar::CompiledGrammar> compiled;
+  std::string error;
+};
+
+// Coalesces concurrent compilations of the same key: the first requester
+// for a key runs the compile, later requesters arriving while it is in
+// flight block on a shared future of the same result instead of compiling
+// again. Entries exist only while a compilation is in flight — once it
+// finishes, repeat requests fall through to the engine's own result cache,
+// so the existing `cache_limit_bytes` eviction still governs retention.
+// The in-flight map is sharded to keep lock contention low at high request
+// rates.
+//
+// Copying a `CompileCoalescer` shares its state (like the engine's own
+// handle types), so async launchers can copy it into detached closures
+// that may outlive the owning compiler.
+class CompileCoalescer {
+ public:
+  CompileCoalescer() : state_(std::make_shared<State>()) {}
+
+  template <typename Fn>
+  SharedCompileResult Compile(uint64_t key, Fn&& compile) {
+    Shard& shard = state_->shards[key % kNumShards];
+    std::promise<SharedCompileResult> promise;
+    std::shared_future<SharedCompileResult> shared;
+    bool leader = false;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.inflight.find(key);
+      if (it != shard.inflight.end()) {
+        shared = it->second;
+      } else {
+        leader = true;
+        shared = promise.get_future().share();
+        shard.inflight.emplace(key, shared);
+      }
+    }
+    if (!leader) {
+      state_->coalesced_waits.fetch_add(1, std::memory_order_relaxed);
+      return shared.get();
+    }
+
+    SharedCompileResult result;
+    try {
+      result.compiled = compile();
+    } catch (const std::exception& e) {
+      result.error = e.what();
+    } catch (...) {
+      result.error = "unknown C++ exception";
+    }
+    promise.set_value(result);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.inflight.erase(key);
+    }
+    return result;
+  }
+
+  // How many requests joined an in-flight compilation instead of starting
+  // their own. Useful for verifying that a thundering herd was coalesced.
+  uint64_t CoalescedWaits() const {
+    return state_->coalesced_waits.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::shared_future<SharedCompileResult>>
+        inflight;
+  };
+
+  struct State {
+    Shard shards[kNumShards];
+    std::atomic<uint64_t> coalesced_waits{0};
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+inline std::unique_ptr<CompileCoalescer> make_compile_coalescer() {
+  return std::make_unique<CompileCoalescer>();
+}
+
+inline uint64_t coalescer_coalesced_waits(const CompileCoalescer& self) {
+  return self.CoalescedWaits();
+}
+
+inline std::unique_ptr<xgrammar::CompiledGrammar>
+coalescer_compile_json_schema(
+    CompileCoalescer& self,
+    xgrammar::GrammarCompiler& compiler,
+    uint64_t key,
+    const std::string& schema,
+    bool any_whitespace,
+    bool has_indent,
+    int32_t indent,
+    bool has_separators,
+    const std::string& separator_comma,
+    const std::string& separator_colon,
+    bool strict_mode,
+    bool has_max_whitespace_cnt,
+    int32_t max_whitespace_cnt,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+    std::optional<int> indent_opt =
+        has_indent ? std::optional<int>(indent) : std::nullopt;
+    std::optional<std::pair<std::string, std::string>> sep_opt =
+        has_separators ? std::optional<std::pair<std::string, std::string>>(
+                             std::make_pair(separator_comma, separator_colon)
+                         )
+                       : std::nullopt;
+    std::optional<int> max_whitespace_cnt_opt =
+        has_max_whitespace_cnt ? std::optional<int>(max_whitespace_cnt)
+                               : std::nullopt;
+    SharedCompileResult result = self.Compile(key, [&]() {
+      return compiler.CompileJSONSchema(
+          schema,
+          any_whitespace,
+          indent_opt,
+          sep_opt,
+          strict_mode,
+          max_whitespace_cnt_opt
+      );
+    });
+    if (!result.compiled) {
+      if (error_out) {
+        *error_out = result.error;
+      }
+      return nullptr;
+    }
+    return make_unique(std::move(*result.compiled));
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
+inline std::unique_ptr<CompileFuture> coalescer_compile_json_schema_async(
+    CompileCoalescer& self,
+    xgrammar::GrammarCompiler& compiler,
+    uint64_t key,
+    const std::string& schema,
+    bool any_whitespace,
+    bool has_indent,
+    int32_t indent,
+    bool has_separators,
+    const std::string& separator_comma,
+    const std::string& separator_colon,
+    bool strict_mode,
+    bool has_max_whitespace_cnt,
+    int32_t max_whitespace_cnt,
+    std::string* error_out
+) {
+  std::optional<int> indent_opt =
+      has_indent ? std::optional<int>(indent) : std::nullopt;
+  std::optional<std::pair<std::string, std::string>> sep_opt =
+      has_separators ? std::optional<std::pair<std::string, std::string>>(
+                           std::make_pair(separator_comma, separator_colon)
+                       )
+                     : std::nullopt;
+  std::optional<int> max_whitespace_cnt_opt =
+      has_max_whitespace_cnt ? std::optional<int>(max_whitespace_cnt)
+                             : std::nullopt;
+  CompileCoalescer coalescer = self;
+  return launch_compile(
+      [coalescer,
+       compiler,
+       key,
+       schema,
+       any_whitespace,
+       indent_opt,
+       sep_opt,
+       strict_mode,
+       max_whitespace_cnt_opt]() mutable {
+        SharedCompileResult result = coalescer.Compile(key, [&]() {
+          return compiler.CompileJSONSchema(
+              schema,
+              any_whitespace,
+              indent_opt,
+              sep_opt,
+              strict_mode,
+              max_whitespace_cnt_opt
+          );
+        });
+        if (!result.compiled) {
+          throw std::runtime_error(result.error);
+        }
+        return std::move(*result.compiled);
+      },
+      error_out
+  );
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_COALESCE_H_
@@ -0,0 +1,218 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_COMPILE_FUTURE_H_
+#define XGRAMMAR_RS_CXX_UTILS_COMPILE_FUTURE_H_
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "xgrammar/xgrammar.h"
+
+#include "common.hpp"
+
+namespace cxx_utils {
+
+// Result of one asynchronous compilation. Exactly one of `compiled` and
+// `error` is meaningful: `compiled` is null iff the compilation failed.
+struct CompileResult {
+  std::unique_ptr<xgrammar::CompiledGrammar> compiled;
+  std::string error;
+};
+
+// Opaque handle to an in-flight compilation, returned by the
+// `compiler_compile_*_async` launchers below. The result is claimed exactly
+// once via `compile_future_wait`; `is_ready` can be polled without blocking.
+class CompileFuture {
+ public:
+  explicit CompileFuture(std::future<CompileResult>&& future)
+      : future_(std::move(future)) {}
+
+  bool is_ready() const {
+    return future_.valid() &&
+           future_.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+  }
+
+  std::unique_ptr<xgrammar::CompiledGrammar> wait(std::string* error_out) {
+    try {
+      if (error_out) {
+        error_out->clear();
+      }
+      if (!future_.valid()) {
+        if (error_out) {
+          *error_out = "compile future result was already taken";
+        }
+        return nullptr;
+      }
+      CompileResult result = future_.get();
+      if (!result.compiled) {
+        if (error_out) {
+          *error_out = result.error;
+        }
+        return nullptr;
+      }
+      return std::move(result.compiled);
+    } catch (const std::exception& e) {
+      if (error_out) {
+        *error_out = e.what();
+      }
+      return nullptr;
+    } catch (...) {
+      if (error_out) {
+        *error_out = "unknown C++ exception";
+      }
+      return nullptr;
+    }
+  }
+
+ private:
+  std::future<CompileResult> future_;
+};
+
+// Runs `compile` on a detached submission thread and wraps the outcome in a
+// `CompileFuture`. `compile` must own (copies of) everything it touches:
+// `xgrammar` objects are cheap shared-state handles, so launchers copy the
+// compiler handle into the closure and share its thread pool and cache.
+template <typename Fn>
+inline std::unique_ptr<CompileFuture> launch_compile(
+    Fn compile,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+    auto future = std::async(
+        std::launch::async,
+        [compile = std::move(compile)]() mutable -> CompileResult {
+          CompileResult result;
+          try {
+            result.compiled = make_unique(compile());
+          } catch (const std::exception& e) {
+            result.error = e.what();
+          } catch (...) {
+            result.error = "unknown C++ exception";
+          }
+          return result;
+        }
+    );
+    return std::make_unique<CompileFuture>(std::move(future));
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
+inline std::unique_ptr<CompileFuture> compiler_compile_json_schema_async(
+    xgrammar::GrammarCompiler& compiler,
+    const std::string& schema,
+    bool any_whitespace,
+    bool has_indent,
+    int32_t indent,
+    bool has_separators,
+    const std::string& separator_comma,
+    const std::string& separator_colon,
+    bool strict_mode,
+    bool has_max_whitespace_cnt,
+    int32_t max_whitespace_cnt,
+    std::string* error_out
+) {
+  std::optional<int> indent_opt =
+      has_indent ? std::optional<int>(indent) : std::nullopt;
+  std::optional<std::pair<std::string, std::string>> sep_opt =
+      has_separators ? std::optional<std::pair<std::string, std::string>>(
+                           std::make_pair(separator_comma, separator_colon)
+                       )
+                     : std::nullopt;
+  std::optional<int> max_whitespace_cnt_opt =
+      has_max_whitespace_cnt ? std::optional<int>(max_whitespace_cnt)
+                             : std::nullopt;
+  return launch_compile(
+      [compiler,
+       schema,
+       any_whitespace,
+       indent_opt,
+       sep_opt,
+       strict_mode,
+       max_whitespace_cnt_opt]() mutable {
+        return compiler.CompileJSONSchema(
+            schema,
+            any_whitespace,
+            indent_opt,
+            sep_opt,
+            strict_mode,
+            max_whitespace_cnt_opt
+        );
+      },
+      error_out
+  );
+}
+
+inline std::unique_ptr<CompileFuture> compiler_compile_builtin_json_async(
+    xgrammar::GrammarCompiler& compiler,
+    std::string* error_out
+) {
+  return launch_compile(
+      [compiler]() mutable { return compiler.CompileBuiltinJSONGrammar(); },
+      error_out
+  );
+}
+
+inline std::unique_ptr<CompileFuture> compiler_compile_regex_async(
+    xgrammar::GrammarCompiler& compiler,
+    const std::string& regex,
+    std::string* error_out
+) {
+  return launch_compile(
+      [compiler, regex]() mutable { return compiler.CompileRegex(regex); },
+      error_out
+  );
+}
+
+inline std::unique_ptr<CompileFuture> compiler_compile_structural_tag_async(
+    xgrammar::GrammarCompiler& compiler,
+    const std::string& structural_tag_json,
+    std::string* error_out
+) {
+  return launch_compile(
+      [compiler, structural_tag_json]() mutable {
+        return compiler.CompileStructuralTag(structural_tag_json);
+      },
+      error_out
+  );
+}
+
+inline std::unique_ptr<CompileFuture> compiler_compile_grammar_async(
+    xgrammar::GrammarCompiler& compiler,
+    const xgrammar::Grammar& grammar,
+    std::string* error_out
+) {
+  return launch_compile(
+      [compiler, grammar]() mutable { return compiler.CompileGrammar(grammar); },
+      error_out
+  );
+}
+
+inline bool compile_future_is_ready(const CompileFuture& future) {
+  return future.is_ready();
+}
+
+inline std::unique_ptr<xgrammar::CompiledGrammar> compile_future_wait(
+    CompileFuture& future,
+    std::string* error_out
+) {
+  return future.wait(error_out);
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_COMPILE_FUTURE_H_
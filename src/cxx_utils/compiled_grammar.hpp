@@ -50,6 +50,15 @@ inline std::unique_ptr<std::string> compiled_grammar_serialize_json(
   return make_unique(self.SerializeJSON());
 }
 
+// CompiledGrammar is a shared handle to immutable compiled state, so copying
+// it shares that state instead of duplicating it; this is how caches hand
+// out the same compilation result to multiple callers.
+inline std::unique_ptr<xgrammar::CompiledGrammar> compiled_grammar_clone(
+    const xgrammar::CompiledGrammar& self
+) {
+  return make_unique(xgrammar::CompiledGrammar(self));
+}
+
 } // namespace cxx_utils
 
 #endif // XGRAMMAR_RS_CXX_UTILS_COMPILED_GRAMMAR_H_
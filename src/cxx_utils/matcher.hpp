@@ -1,20 +1,48 @@
 #ifndef XGRAMMAR_RS_CXX_UTILS_MATCHER_H_
 #define XGRAMMAR_RS_CXX_UTILS_MATCHER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <vector>
 #include <string>
 
 #include "xgrammar/xgrammar.h"
 
+#include "bitmask_kernels.hpp"
 #include "common.hpp"
 #include "dlpack.hpp"
+#include "status.hpp"
 
 namespace cxx_utils {
 
+// The engine's matcher entry points take `std::vector` arguments, so the raw
+// arrays the Rust side passes in have to be materialized as vectors. The
+// helpers below keep one vector per call site per thread and reuse its
+// capacity across calls, so the steady-state decode loop performs no
+// allocations here; the vectors are moved into `std::optional` arguments and
+// recovered afterwards to preserve their capacity. Span-based engine
+// overloads would remove the copy entirely.
+
+template <typename T>
+inline void fill_scratch(
+    std::vector<T>& scratch,
+    const int32_t* ptr,
+    size_t len
+) {
+  scratch.clear();
+  scratch.reserve(len);
+  for (size_t i = 0; i < len; ++i) {
+    scratch.push_back(static_cast<T>(ptr[i]));
+  }
+}
+
 inline std::unique_ptr<xgrammar::GrammarMatcher> make_grammar_matcher(
     const xgrammar::CompiledGrammar& compiled_grammar,
     bool has_override_stop_tokens,
@@ -37,17 +65,17 @@ inline std::unique_ptr<xgrammar::GrammarMatcher> make_grammar_matcher(
           max_rollback_tokens
       );
     }
-    std::vector<int> tmp;
-    tmp.reserve(override_stop_tokens_len);
-    for (size_t i = 0; i < override_stop_tokens_len; ++i) {
-      tmp.push_back(static_cast<int>(override_stop_tokens_ptr[i]));
-    }
-    return std::make_unique<xgrammar::GrammarMatcher>(
+    thread_local std::vector<int> scratch;
+    fill_scratch(scratch, override_stop_tokens_ptr, override_stop_tokens_len);
+    std::optional<std::vector<int>> stop_tokens_opt(std::move(scratch));
+    auto matcher = std::make_unique<xgrammar::GrammarMatcher>(
         compiled_grammar,
-        std::optional<std::vector<int>>(std::move(tmp)),
+        stop_tokens_opt,
         terminate_without_stop_token,
         max_rollback_tokens
     );
+    scratch = std::move(*stop_tokens_opt);
+    return matcher;
   } catch (const std::exception& e) {
     if (error_out) {
       *error_out = e.what();
@@ -100,7 +128,124 @@ inline void grammar_matcher_vec_push(
   vec.push_back(matcher);
 }
 
-inline void batch_matcher_batch_fill_next_token_bitmask(
+// Constructs `count` matchers over one compiled grammar in a single call,
+// spreading initialization over up to `max_threads` threads (`-1` uses
+// `hardware_concurrency() / 2`, like the batch matcher). Building a large
+// batch this way costs one FFI crossing instead of one construct-then-copy
+// round-trip per sequence; matchers are claimed from the returned vector
+// with `grammar_matcher_vec_take`. The first construction failure wins and
+// is reported through `error_out`.
+inline std::unique_ptr<std::vector<xgrammar::GrammarMatcher>>
+batch_make_grammar_matchers(
+    const xgrammar::CompiledGrammar& compiled_grammar,
+    size_t count,
+    bool has_override_stop_tokens,
+    const int32_t* override_stop_tokens_ptr,
+    size_t override_stop_tokens_len,
+    bool terminate_without_stop_token,
+    int32_t max_rollback_tokens,
+    int32_t max_threads,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+    std::optional<std::vector<int>> stop_tokens_opt;
+    if (has_override_stop_tokens) {
+      stop_tokens_opt.emplace(
+          override_stop_tokens_ptr,
+          override_stop_tokens_ptr + override_stop_tokens_len
+      );
+    }
+
+    std::vector<std::optional<xgrammar::GrammarMatcher>> slots(count);
+
+    size_t num_threads;
+    if (max_threads < 0) {
+      num_threads = std::max<size_t>(
+          std::thread::hardware_concurrency() / 2,
+          1
+      );
+    } else {
+      num_threads = std::max<size_t>(static_cast<size_t>(max_threads), 1);
+    }
+    num_threads = std::min(num_threads, count);
+
+    std::mutex error_mutex;
+    std::string first_error;
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+      while (true) {
+        const size_t i = next_index.fetch_add(1);
+        if (i >= count) {
+          return;
+        }
+        try {
+          slots[i].emplace(
+              compiled_grammar,
+              stop_tokens_opt,
+              terminate_without_stop_token,
+              max_rollback_tokens
+          );
+        } catch (const std::exception& e) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (first_error.empty()) {
+            first_error = e.what();
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (first_error.empty()) {
+            first_error = "unknown C++ exception";
+          }
+        }
+      }
+    };
+    if (num_threads <= 1) {
+      worker();
+    } else {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+
+    if (!first_error.empty()) {
+      if (error_out) {
+        *error_out = first_error;
+      }
+      return nullptr;
+    }
+    auto result = std::make_unique<std::vector<xgrammar::GrammarMatcher>>();
+    result->reserve(count);
+    for (auto& slot : slots) {
+      result->push_back(std::move(*slot));
+    }
+    return result;
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
+// The batch functions below use the exception-free status ABI from
+// status.hpp: they are `noexcept`, return a numeric status code, and write
+// failure detail into the thread-local buffer only when something fails, so
+// the per-step success path carries no error-string traffic. Results go into
+// caller-provided buffers instead of freshly allocated vectors.
+
+inline int32_t batch_fill_next_token_bitmask_status(
     xgrammar::BatchGrammarMatcher& batch_matcher,
     std::vector<xgrammar::GrammarMatcher>* matchers,
     DLTensor* bitmask,
@@ -108,12 +253,13 @@ inline void batch_matcher_batch_fill_next_token_bitmask(
     const int32_t* indices_ptr,
     size_t indices_len,
     bool debug_print
-) {
-  try {
+) noexcept {
+  return run_status([&]() {
+    thread_local std::vector<int32_t> scratch;
     std::optional<std::vector<int32_t>> indices_opt;
     if (has_indices) {
-      std::vector<int32_t> tmp(indices_ptr, indices_ptr + indices_len);
-      indices_opt = std::move(tmp);
+      fill_scratch(scratch, indices_ptr, indices_len);
+      indices_opt = std::move(scratch);
     }
     batch_matcher.BatchFillNextTokenBitmask(
         matchers,
@@ -121,64 +267,73 @@ inline void batch_matcher_batch_fill_next_token_bitmask(
         indices_opt,
         debug_print
     );
-  } catch (...) {
-  }
+    if (indices_opt.has_value()) {
+      scratch = std::move(*indices_opt);
+    }
+    return kStatusOk;
+  });
 }
 
-inline std::unique_ptr<std::vector<uint8_t>> batch_accept_token(
+inline int32_t batch_accept_token_status(
     std::vector<xgrammar::GrammarMatcher>* matchers,
     const int32_t* token_ids_ptr,
     size_t token_ids_len,
-    bool debug_print
-) {
-  try {
-    std::vector<int32_t> token_ids(
-        token_ids_ptr,
-        token_ids_ptr + token_ids_len
-    );
-    return make_unique(
-        xgrammar::BatchGrammarMatcher::BatchAcceptToken(
-            matchers,
-            token_ids,
-            debug_print
-        )
+    bool debug_print,
+    uint8_t* accepted_out
+) noexcept {
+  return run_status([&]() {
+    thread_local std::vector<int32_t> token_ids;
+    fill_scratch(token_ids, token_ids_ptr, token_ids_len);
+    auto oks = xgrammar::BatchGrammarMatcher::BatchAcceptToken(
+        matchers,
+        token_ids,
+        debug_print
     );
-  } catch (...) {
-    return std::make_unique<std::vector<uint8_t>>(token_ids_len, 0);
-  }
+    if (oks.size() != token_ids_len) {
+      return set_status_error(
+          kStatusInternal,
+          "BatchAcceptToken returned an unexpected result size"
+      );
+    }
+    std::copy(oks.begin(), oks.end(), accepted_out);
+    return kStatusOk;
+  });
 }
 
-inline std::unique_ptr<std::vector<uint8_t>> batch_accept_string(
+inline int32_t batch_accept_string_status(
     std::vector<xgrammar::GrammarMatcher>* matchers,
     const std::vector<std::string>& strings,
-    bool debug_print
-) {
-  try {
-    return make_unique(
-        xgrammar::BatchGrammarMatcher::BatchAcceptString(
-            matchers,
-            strings,
-            debug_print
-        )
+    bool debug_print,
+    uint8_t* accepted_out
+) noexcept {
+  return run_status([&]() {
+    auto oks = xgrammar::BatchGrammarMatcher::BatchAcceptString(
+        matchers,
+        strings,
+        debug_print
     );
-  } catch (...) {
-    return std::make_unique<std::vector<uint8_t>>(strings.size(), 0);
-  }
+    if (oks.size() != strings.size()) {
+      return set_status_error(
+          kStatusInternal,
+          "BatchAcceptString returned an unexpected result size"
+      );
+    }
+    std::copy(oks.begin(), oks.end(), accepted_out);
+    return kStatusOk;
+  });
 }
 
-inline void batch_rollback(
+inline int32_t batch_rollback_status(
     std::vector<xgrammar::GrammarMatcher>* matchers,
     const int32_t* num_tokens_ptr,
     size_t num_tokens_len
-) {
-  try {
-    std::vector<int> num_tokens(
-        num_tokens_ptr,
-        num_tokens_ptr + num_tokens_len
-    );
+) noexcept {
+  return run_status([&]() {
+    thread_local std::vector<int> num_tokens;
+    fill_scratch(num_tokens, num_tokens_ptr, num_tokens_len);
     xgrammar::BatchGrammarMatcher::BatchRollback(matchers, num_tokens);
-  } catch (...) {
-  }
+    return kStatusOk;
+  });
 }
 
 inline std::unique_ptr<std::string> grammar_matcher_find_jump_forward_string(
@@ -187,6 +342,110 @@ inline std::unique_ptr<std::string> grammar_matcher_find_jump_forward_string(
   return make_unique(self.FindJumpForwardString());
 }
 
+// Computes jump-forward strings for all (or an indexed subset of) matchers
+// in one call and packs them into one arena string plus an offsets table
+// (`offsets.size() == n + 1`; entry `i` spans `[offsets[i], offsets[i + 1])`
+// in the arena). The whole batch costs one FFI crossing, and the per-slot
+// scratch strings are thread_local so the steady state reallocates neither
+// them nor their capacity. Work is spread over up to `max_threads` threads
+// (`-1` uses `hardware_concurrency() / 2`, like the batch matcher).
+inline std::unique_ptr<std::vector<size_t>> batch_find_jump_forward_string(
+    std::vector<xgrammar::GrammarMatcher>* matchers,
+    bool has_indices,
+    const int32_t* indices_ptr,
+    size_t indices_len,
+    int32_t max_threads,
+    std::string* arena_out,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+    const size_t n = has_indices ? indices_len : matchers->size();
+    // Validate all indices before any worker runs: an out-of-range index
+    // would be UB in `operator[]`, and throwing from a worker thread would
+    // terminate the process instead of reaching `error_out`.
+    if (has_indices) {
+      for (size_t i = 0; i < indices_len; ++i) {
+        if (indices_ptr[i] < 0 ||
+            static_cast<size_t>(indices_ptr[i]) >= matchers->size()) {
+          if (error_out) {
+            *error_out = "matcher index out of range: " +
+                         std::to_string(indices_ptr[i]);
+          }
+          return nullptr;
+        }
+      }
+    }
+    thread_local std::vector<std::string> results;
+    if (results.size() < n) {
+      results.resize(n);
+    }
+
+    size_t num_threads;
+    if (max_threads < 0) {
+      num_threads = std::max<size_t>(
+          std::thread::hardware_concurrency() / 2,
+          1
+      );
+    } else {
+      num_threads = std::max<size_t>(static_cast<size_t>(max_threads), 1);
+    }
+    num_threads = std::min(num_threads, n);
+
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() {
+      while (true) {
+        const size_t i = next_index.fetch_add(1);
+        if (i >= n) {
+          return;
+        }
+        const size_t matcher_index =
+            has_indices ? static_cast<size_t>(indices_ptr[i]) : i;
+        results[i] = (*matchers)[matcher_index].FindJumpForwardString();
+      }
+    };
+    if (num_threads <= 1) {
+      worker();
+    } else {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+      total += results[i].size();
+    }
+    arena_out->clear();
+    arena_out->reserve(total);
+    auto offsets = std::make_unique<std::vector<size_t>>();
+    offsets->reserve(n + 1);
+    offsets->push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+      arena_out->append(results[i]);
+      offsets->push_back(arena_out->size());
+    }
+    return offsets;
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
 inline std::unique_ptr<std::string> grammar_matcher_debug_print_internal_state(
     const xgrammar::GrammarMatcher& self
 ) {
@@ -202,12 +461,94 @@ inline bool grammar_matcher_fill_next_token_bitmask(
   return self.FillNextTokenBitmask(next_token_bitmask, next, debug_print);
 }
 
+// Replays a snapshot's accepted-token history into a freshly constructed
+// matcher in one FFI crossing. The engine exposes no way to serialize the
+// pushdown state itself, so restoring a snapshot re-derives it by replay;
+// doing the whole loop engine-side avoids one crossing per token. Uses the
+// status ABI; a rejected token reports its index and id in the detail.
+inline int32_t grammar_matcher_replay_tokens_status(
+    xgrammar::GrammarMatcher& self,
+    const int32_t* token_ids_ptr,
+    size_t token_ids_len
+) noexcept {
+  return run_status([&]() -> int32_t {
+    for (size_t i = 0; i < token_ids_len; ++i) {
+      if (!self.AcceptToken(token_ids_ptr[i], false)) {
+        std::string detail = "snapshot replay rejected token id " +
+                             std::to_string(token_ids_ptr[i]) +
+                             " at index " + std::to_string(i) +
+                             "; the snapshot does not match this grammar";
+        return set_status_error(kStatusInvalidArgument, detail.c_str());
+      }
+    }
+    return kStatusOk;
+  });
+}
+
+// Bulk byte acceptance for re-validating large cached or retrieved
+// documents. The byte-by-byte automaton advance itself lives inside the
+// engine's AcceptString; what this entry point removes is the per-call cost
+// around it: the input crosses the FFI as a raw span and is staged in a
+// thread-local buffer whose capacity is reused, so feeding a 100 KB
+// document costs one crossing and no allocations in the steady state
+// (let_cxx_string on the Rust side allocates a fresh CxxString per call).
+inline bool grammar_matcher_accept_bytes(
+    xgrammar::GrammarMatcher& self,
+    const char* input_ptr,
+    size_t input_len,
+    bool debug_print
+) {
+  thread_local std::string scratch;
+  scratch.assign(input_ptr, input_len);
+  return self.AcceptString(scratch, debug_print);
+}
+
 inline std::unique_ptr<xgrammar::GrammarMatcher> grammar_matcher_fork(
     const xgrammar::GrammarMatcher& self
 ) {
   return std::make_unique<xgrammar::GrammarMatcher>(self.Fork());
 }
 
+// Replace `self`'s state with an independent copy of `checkpoint`'s state in
+// one engine-side assignment. The cost tracks the automaton state at the
+// checkpoint, not the number of tokens accepted since it was taken, so
+// jumping back to a branch point does not pay the token-by-token price of a
+// deep `Rollback`.
+inline void grammar_matcher_restore(
+    xgrammar::GrammarMatcher& self,
+    const xgrammar::GrammarMatcher& checkpoint
+) {
+  self = checkpoint.Fork();
+}
+
+// Fork `self` into `n` branches in one call: the branch vector is reserved
+// once and all copies happen on the C++ side, so branch setup costs one FFI
+// crossing instead of `n`. Forked state still deep-copies per branch (the
+// compiled grammar itself is already shared); branches are claimed with
+// `grammar_matcher_vec_take`.
+inline std::unique_ptr<std::vector<xgrammar::GrammarMatcher>>
+grammar_matcher_fork_n(const xgrammar::GrammarMatcher& self, size_t n) {
+  auto branches = std::make_unique<std::vector<xgrammar::GrammarMatcher>>();
+  branches->reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    branches->push_back(self.Fork());
+  }
+  return branches;
+}
+
+// Moves the matcher at `index` out of the vector (the slot is left in a
+// moved-from state and must not be used again). Returns null if `index` is
+// out of range.
+inline std::unique_ptr<xgrammar::GrammarMatcher> grammar_matcher_vec_take(
+    std::vector<xgrammar::GrammarMatcher>& vec,
+    size_t index
+) {
+  if (index >= vec.size()) {
+    return nullptr;
+  }
+  return std::make_unique<xgrammar::GrammarMatcher>(std::move(vec[index]));
+}
+
 inline bool grammar_matcher_traverse_draft_tree(
     xgrammar::GrammarMatcher& self,
     const DLTensor* retrieve_next_token,
@@ -241,27 +582,176 @@ inline bool grammar_matcher_traverse_draft_tree(
   }
 }
 
-inline bool apply_token_bitmask_inplace_cpu(
+// Per-sequence tensor views for one batched draft-tree traversal. cxx cannot
+// pass arrays of raw tensor pointers across the bridge, so the Rust side
+// fills this holder one sequence at a time before the batch call, mirroring
+// the `new_grammar_matcher_vector` builder pattern.
+struct DraftTreeBatch {
+  std::vector<const DLTensor*> retrieve_next_token;
+  std::vector<const DLTensor*> retrieve_next_sibling;
+  std::vector<const DLTensor*> draft_tokens;
+  std::vector<DLTensor*> token_bitmask;
+};
+
+inline std::unique_ptr<DraftTreeBatch> make_draft_tree_batch() {
+  return std::make_unique<DraftTreeBatch>();
+}
+
+inline void draft_tree_batch_reserve(
+    DraftTreeBatch& self,
+    size_t n
+) {
+  self.retrieve_next_token.reserve(n);
+  self.retrieve_next_sibling.reserve(n);
+  self.draft_tokens.reserve(n);
+  self.token_bitmask.reserve(n);
+}
+
+inline void draft_tree_batch_push(
+    DraftTreeBatch& self,
+    const DLTensor* retrieve_next_token,
+    const DLTensor* retrieve_next_sibling,
+    const DLTensor* draft_tokens,
+    DLTensor* token_bitmask
+) {
+  self.retrieve_next_token.push_back(retrieve_next_token);
+  self.retrieve_next_sibling.push_back(retrieve_next_sibling);
+  self.draft_tokens.push_back(draft_tokens);
+  self.token_bitmask.push_back(token_bitmask);
+}
+
+// Traverse the draft trees of all sequences in one call, fanning the
+// independent per-sequence traversals out across worker threads pulling from
+// a shared atomic queue (same scheme as `batch_find_jump_forward_string`).
+//
+// `time_budget` is one deadline shared by the whole batch, not a per-call
+// threshold: each sequence is traversed with whatever budget remains when a
+// worker picks it up, so a slow tree early in the batch shrinks the budget
+// of the rest instead of overshooting the step deadline n times over.
+// Sequences that time out — or never start because the budget is already
+// spent — get a 0 in `completed_out` and fall back to per-token validation;
+// they are not errors. `time_budget <= 0` disables the deadline.
+inline int32_t batch_traverse_draft_tree_status(
+    std::vector<xgrammar::GrammarMatcher>* matchers,
+    const DraftTreeBatch& batch,
+    double time_budget,
+    int32_t max_threads,
+    uint8_t* completed_out
+) noexcept {
+  return run_status([&]() {
+    const size_t n = matchers->size();
+    if (batch.retrieve_next_token.size() != n) {
+      return set_status_error(
+          kStatusInvalidArgument,
+          "draft tree batch size does not match the number of matchers"
+      );
+    }
+    const bool has_deadline = time_budget > 0;
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration<double>(time_budget);
+
+    size_t num_threads;
+    if (max_threads < 0) {
+      num_threads = std::max<size_t>(
+          std::thread::hardware_concurrency() / 2,
+          1
+      );
+    } else {
+      num_threads = std::max<size_t>(static_cast<size_t>(max_threads), 1);
+    }
+    num_threads = std::min(num_threads, n);
+
+    std::atomic<size_t> next_index{0};
+    std::mutex error_mutex;
+    std::exception_ptr first_error;
+    auto worker = [&]() {
+      while (true) {
+        const size_t i = next_index.fetch_add(1);
+        if (i >= n) {
+          return;
+        }
+        double remaining = -1;
+        if (has_deadline) {
+          remaining = std::chrono::duration<double>(
+                          deadline - std::chrono::steady_clock::now()
+          )
+                          .count();
+          if (remaining <= 0) {
+            completed_out[i] = 0;
+            continue;
+          }
+        }
+#if defined(__cpp_exceptions)
+        try {
+#endif
+          completed_out[i] = (*matchers)[i].TraverseDraftTree(
+                                 batch.retrieve_next_token[i],
+                                 batch.retrieve_next_sibling[i],
+                                 batch.draft_tokens[i],
+                                 batch.token_bitmask[i],
+                                 remaining
+                             )
+                                 ? 1
+                                 : 0;
+#if defined(__cpp_exceptions)
+        } catch (...) {
+          completed_out[i] = 0;
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!first_error) {
+            first_error = std::current_exception();
+          }
+        }
+#endif
+      }
+    };
+    if (num_threads <= 1) {
+      worker();
+    } else {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+#if defined(__cpp_exceptions)
+    if (first_error) {
+      std::rethrow_exception(first_error);
+    }
+#endif
+    return kStatusOk;
+  });
+}
+
+inline int32_t apply_token_bitmask_inplace_cpu_status(
     DLTensor* logits,
     const DLTensor* bitmask,
     int32_t vocab_size,
     bool has_indices,
     const int32_t* indices_ptr,
-    size_t indices_len,
-    std::string* error_out
-) {
-  try {
-    if (error_out) {
-      error_out->clear();
+    size_t indices_len
+) noexcept {
+  return run_status([&]() {
+    // Vectorized path for f32/f16/bf16 logits with standard layouts. Falls
+    // through to the engine implementation (scalar, f32-only) for anything
+    // it does not handle, including genuinely invalid inputs, so error
+    // behavior is unchanged.
+    if (bitmask_kernels::apply_token_bitmask_fast_path(
+            logits,
+            bitmask,
+            vocab_size,
+            has_indices ? indices_ptr : nullptr,
+            indices_len
+        )) {
+      return kStatusOk;
     }
+    thread_local std::vector<int> scratch;
     std::optional<std::vector<int>> indices_opt = std::nullopt;
     if (has_indices) {
-      std::vector<int> tmp;
-      tmp.reserve(indices_len);
-      for (size_t i = 0; i < indices_len; ++i) {
-        tmp.push_back(static_cast<int>(indices_ptr[i]));
-      }
-      indices_opt = std::move(tmp);
+      fill_scratch(scratch, indices_ptr, indices_len);
+      indices_opt = std::move(scratch);
     }
     xgrammar::ApplyTokenBitmaskInplaceCPU(
         logits,
@@ -269,17 +759,48 @@ inline bool apply_token_bitmask_inplace_cpu(
         static_cast<int>(vocab_size),
         indices_opt
     );
-    return true;
-  } catch (const std::exception& e) {
-    if (error_out) {
-      *error_out = e.what();
-    }
-    return false;
-  } catch (...) {
-    if (error_out) {
-      *error_out = "unknown C++ exception";
+    if (indices_opt.has_value()) {
+      scratch = std::move(*indices_opt);
     }
-    return false;
+    return kStatusOk;
+  });
+}
+
+// Device-dispatching variant of the masking entry point. CPU (and
+// CUDA-host-pinned) logits take the vectorized CPU path above; other devices
+// report an error naming the device. This is the single dispatch point where
+// CUDA/Metal kernels plug in once device backends are built into the crate,
+// so callers do not change when that happens.
+inline int32_t apply_token_bitmask_inplace_status(
+    DLTensor* logits,
+    const DLTensor* bitmask,
+    int32_t vocab_size,
+    bool has_indices,
+    const int32_t* indices_ptr,
+    size_t indices_len
+) noexcept {
+  if (!logits) {
+    return set_status_error(kStatusInvalidArgument, "logits tensor is null");
+  }
+  switch (logits->device.device_type) {
+    case kDLCPU:
+    case kDLCUDAHost:
+      return apply_token_bitmask_inplace_cpu_status(
+          logits,
+          bitmask,
+          vocab_size,
+          has_indices,
+          indices_ptr,
+          indices_len
+      );
+    default:
+      return set_status_error(
+          kStatusInvalidArgument,
+          ("apply_token_bitmask_inplace: no kernel for device type " +
+           std::to_string(static_cast<int>(logits->device.device_type)) +
+           " in this build; only CPU logits are supported")
+              .c_str()
+      );
   }
 }
 
@@ -0,0 +1,237 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_MATCHER_PIPELINE_H_
+#define XGRAMMAR_RS_CXX_UTILS_MATCHER_PIPELINE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "xgrammar/xgrammar.h"
+
+#include "common.hpp"
+#include "dlpack.hpp"
+
+namespace cxx_utils {
+
+// A double-buffer-friendly pipeline around `xgrammar::BatchGrammarMatcher`.
+//
+// One step is submitted as "accept these tokens, then fill the next-token
+// bitmask into this tensor" and runs on a persistent worker thread, so the
+// 1-3 ms batch fill for step t+1 overlaps the GPU forward pass of step t.
+// The caller alternates between two bitmask tensors: while the worker fills
+// one, the previously filled one is applied and sampled from.
+//
+// At most one step is in flight. The matcher handles are copied into the
+// pipeline (sharing state with the caller's matchers, like the other batch
+// helpers), but the bitmask tensor is borrowed: it, and the matchers'
+// shared state, must not be touched between `submit` and `wait`.
+class BatchMatcherPipeline {
+ public:
+  explicit BatchMatcherPipeline(int32_t max_threads)
+      : batch_matcher_(max_threads), worker_([this]() { WorkerLoop(); }) {}
+
+  ~BatchMatcherPipeline() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+  BatchMatcherPipeline(const BatchMatcherPipeline&) = delete;
+  BatchMatcherPipeline& operator=(const BatchMatcherPipeline&) = delete;
+
+  bool submit(
+      const std::vector<xgrammar::GrammarMatcher>& matchers,
+      const int32_t* token_ids_ptr,
+      size_t token_ids_len,
+      DLTensor* bitmask,
+      bool has_indices,
+      const int32_t* indices_ptr,
+      size_t indices_len,
+      bool debug_print,
+      std::string* error_out
+  ) {
+    if (error_out) {
+      error_out->clear();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (job_pending_ || job_running_ || result_ready_) {
+      if (error_out) {
+        *error_out = "a pipeline step is already in flight; call wait() first";
+      }
+      return false;
+    }
+    matchers_ = matchers;
+    token_ids_.assign(token_ids_ptr, token_ids_ptr + token_ids_len);
+    bitmask_ = bitmask;
+    has_indices_ = has_indices;
+    if (has_indices) {
+      indices_.assign(indices_ptr, indices_ptr + indices_len);
+    } else {
+      indices_.clear();
+    }
+    debug_print_ = debug_print;
+    job_pending_ = true;
+    cv_.notify_all();
+    return true;
+  }
+
+  std::unique_ptr<std::vector<uint8_t>> wait(std::string* error_out) {
+    if (error_out) {
+      error_out->clear();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!job_pending_ && !job_running_ && !result_ready_) {
+      if (error_out) {
+        *error_out = "no pipeline step is in flight";
+      }
+      return nullptr;
+    }
+    cv_.wait(lock, [this]() { return result_ready_; });
+    result_ready_ = false;
+    if (!error_.empty()) {
+      if (error_out) {
+        *error_out = std::move(error_);
+      }
+      error_.clear();
+      return nullptr;
+    }
+    return std::make_unique<std::vector<uint8_t>>(std::move(accept_results_));
+  }
+
+ private:
+  void WorkerLoop() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return job_pending_ || stop_; });
+        if (stop_) {
+          return;
+        }
+        job_pending_ = false;
+        job_running_ = true;
+      }
+      // Only the worker touches the job state while `job_running_` is set.
+      std::vector<uint8_t> oks;
+      std::string error;
+      try {
+        oks = xgrammar::BatchGrammarMatcher::BatchAcceptToken(
+            &matchers_,
+            token_ids_,
+            debug_print_
+        );
+        std::optional<std::vector<int32_t>> indices_opt;
+        if (has_indices_) {
+          indices_opt = indices_;
+        }
+        batch_matcher_.BatchFillNextTokenBitmask(
+            &matchers_,
+            bitmask_,
+            indices_opt,
+            debug_print_
+        );
+      } catch (const std::exception& e) {
+        error = e.what();
+      } catch (...) {
+        error = "unknown C++ exception";
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        accept_results_ = std::move(oks);
+        error_ = std::move(error);
+        job_running_ = false;
+        result_ready_ = true;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  xgrammar::BatchGrammarMatcher batch_matcher_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  bool job_pending_ = false;
+  bool job_running_ = false;
+  bool result_ready_ = false;
+
+  // Job state, written by `submit` and read by the worker.
+  std::vector<xgrammar::GrammarMatcher> matchers_;
+  std::vector<int32_t> token_ids_;
+  DLTensor* bitmask_ = nullptr;
+  bool has_indices_ = false;
+  std::vector<int32_t> indices_;
+  bool debug_print_ = false;
+
+  // Job outcome, written by the worker and read by `wait`.
+  std::vector<uint8_t> accept_results_;
+  std::string error_;
+
+  std::thread worker_;
+};
+
+inline std::unique_ptr<BatchMatcherPipeline> make_batch_matcher_pipeline(
+    int32_t max_threads,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+    return std::make_unique<BatchMatcherPipeline>(max_threads);
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
+inline bool batch_matcher_pipeline_submit(
+    BatchMatcherPipeline& pipeline,
+    const std::vector<xgrammar::GrammarMatcher>& matchers,
+    const int32_t* token_ids_ptr,
+    size_t token_ids_len,
+    DLTensor* bitmask,
+    bool has_indices,
+    const int32_t* indices_ptr,
+    size_t indices_len,
+    bool debug_print,
+    std::string* error_out
+) {
+  return pipeline.submit(
+      matchers,
+      token_ids_ptr,
+      token_ids_len,
+      bitmask,
+      has_indices,
+      indices_ptr,
+      indices_len,
+      debug_print,
+      error_out
+  );
+}
+
+inline std::unique_ptr<std::vector<uint8_t>> batch_matcher_pipeline_wait(
+    BatchMatcherPipeline& pipeline,
+    std::string* error_out
+) {
+  return pipeline.wait(error_out);
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_MATCHER_PIPELINE_H_
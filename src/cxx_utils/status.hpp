@@ -0,0 +1,64 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_STATUS_H_
+#define XGRAMMAR_RS_CXX_UTILS_STATUS_H_
+
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace cxx_utils {
+
+// Exception-free status ABI for the steady-state glue functions.
+//
+// Hot-path functions return a numeric status code and are `noexcept`;
+// failure detail goes into a thread-local buffer that is written only when
+// something fails, so the success path carries no string traffic at all (the
+// error_out convention clears a caller string on every call). The detail for
+// the most recent non-ok status on this thread is fetched with
+// `copy_status_detail`.
+//
+// `run_status` is the single place that knows about exceptions: with
+// exceptions enabled it converts anything the engine throws into a status
+// code, and under `-fno-exceptions` it compiles down to a plain call, which
+// keeps the glue buildable for the lean WASI configuration.
+
+constexpr int32_t kStatusOk = 0;
+constexpr int32_t kStatusInvalidArgument = 1;
+constexpr int32_t kStatusInternal = 2;
+constexpr int32_t kStatusUnknown = 3;
+
+inline std::string& status_detail_buffer() {
+  thread_local std::string detail;
+  return detail;
+}
+
+inline int32_t set_status_error(
+    int32_t code,
+    const char* detail
+) {
+  status_detail_buffer().assign(detail);
+  return code;
+}
+
+inline void copy_status_detail(std::string* out) {
+  *out = status_detail_buffer();
+}
+
+template <typename Fn>
+inline int32_t run_status(Fn&& fn) noexcept {
+#if defined(__cpp_exceptions)
+  try {
+    return std::forward<Fn>(fn)();
+  } catch (const std::exception& e) {
+    return set_status_error(kStatusInternal, e.what());
+  } catch (...) {
+    return set_status_error(kStatusUnknown, "unknown C++ exception");
+  }
+#else
+  return std::forward<Fn>(fn)();
+#endif
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_STATUS_H_
@@ -66,6 +66,105 @@ inline std::unique_ptr<xgrammar::TokenizerInfo> make_tokenizer_info(
   }
 }
 
+/**
+ * Unpacks a vocabulary shipped as one contiguous byte buffer plus an offsets
+ * table (`offsets_len == num_tokens + 1`, token i spans
+ * `[offsets[i], offsets[i + 1])`). Returns false on a malformed table.
+ */
+inline bool unpack_vocab_buffer(
+    const char* buffer_ptr,
+    size_t buffer_len,
+    const size_t* offsets_ptr,
+    size_t offsets_len,
+    std::vector<std::string>* vocab_out
+) {
+  if (offsets_len == 0) {
+    return true;
+  }
+  vocab_out->reserve(offsets_len - 1);
+  for (size_t i = 0; i + 1 < offsets_len; ++i) {
+    size_t begin = offsets_ptr[i];
+    size_t end = offsets_ptr[i + 1];
+    if (begin > end || end > buffer_len) {
+      return false;
+    }
+    vocab_out->emplace_back(buffer_ptr + begin, end - begin);
+  }
+  return true;
+}
+
+/**
+ * Bulk variant of `make_tokenizer_info` that ingests the whole vocabulary in
+ * a single FFI crossing. The engine constructor still takes
+ * `std::vector<std::string>`, so one C++-side copy of the bytes remains, but
+ * the per-token FFI calls and Rust-side staging vector are gone.
+ */
+inline std::unique_ptr<xgrammar::TokenizerInfo> make_tokenizer_info_from_packed(
+    const char* buffer_ptr,
+    size_t buffer_len,
+    const size_t* offsets_ptr,
+    size_t offsets_len,
+    xgrammar::VocabType vocab_type,
+    bool has_vocab_size,
+    int32_t vocab_size,
+    bool has_stop_ids,
+    const int32_t* stop_token_ids_ptr,
+    size_t stop_token_ids_len,
+    bool add_prefix_space,
+    std::string* error_out
+) {
+  try {
+    if (error_out) {
+      error_out->clear();
+    }
+
+    std::vector<std::string> encoded_vocab;
+    if (!unpack_vocab_buffer(
+            buffer_ptr,
+            buffer_len,
+            offsets_ptr,
+            offsets_len,
+            &encoded_vocab
+        )) {
+      if (error_out) {
+        *error_out = "invalid vocab offsets table";
+      }
+      return nullptr;
+    }
+
+    std::optional<int> vs = std::nullopt;
+    if (has_vocab_size) {
+      vs = vocab_size;
+    }
+
+    std::optional<std::vector<int32_t>> stops = std::nullopt;
+    if (has_stop_ids) {
+      stops = std::vector<int32_t>(
+          stop_token_ids_ptr,
+          stop_token_ids_ptr + stop_token_ids_len
+      );
+    }
+
+    return std::make_unique<xgrammar::TokenizerInfo>(
+        std::move(encoded_vocab),
+        vocab_type,
+        vs,
+        stops,
+        add_prefix_space
+    );
+  } catch (const std::exception& e) {
+    if (error_out) {
+      *error_out = e.what();
+    }
+    return nullptr;
+  } catch (...) {
+    if (error_out) {
+      *error_out = "unknown C++ exception";
+    }
+    return nullptr;
+  }
+}
+
 inline std::unique_ptr<xgrammar::TokenizerInfo>
 tokenizer_info_from_vocab_and_metadata(
     const std::vector<std::string>& encoded_vocab,
@@ -76,6 +175,37 @@ tokenizer_info_from_vocab_and_metadata(
   );
 }
 
+/** Packed-buffer counterpart of `tokenizer_info_from_vocab_and_metadata`. */
+inline std::unique_ptr<xgrammar::TokenizerInfo>
+tokenizer_info_from_packed_vocab_and_metadata(
+    const char* buffer_ptr,
+    size_t buffer_len,
+    const size_t* offsets_ptr,
+    size_t offsets_len,
+    const std::string& metadata
+) {
+  std::vector<std::string> encoded_vocab;
+  if (!unpack_vocab_buffer(
+          buffer_ptr,
+          buffer_len,
+          offsets_ptr,
+          offsets_len,
+          &encoded_vocab
+      )) {
+    return nullptr;
+  }
+  return make_unique(
+      xgrammar::TokenizerInfo::FromVocabAndMetadata(encoded_vocab, metadata)
+  );
+}
+
+/** Copies the handle; the underlying tokenizer data is shared (PImpl). */
+inline std::unique_ptr<xgrammar::TokenizerInfo> tokenizer_info_clone(
+    const xgrammar::TokenizerInfo& self
+) {
+  return std::make_unique<xgrammar::TokenizerInfo>(self);
+}
+
 inline std::unique_ptr<std::string> tokenizer_info_serialize_json(
     const xgrammar::TokenizerInfo& self
 ) {
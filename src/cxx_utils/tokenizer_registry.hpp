@@ -0,0 +1,74 @@
+#ifndef XGRAMMAR_RS_CXX_UTILS_TOKENIZER_REGISTRY_H_
+#define XGRAMMAR_RS_CXX_UTILS_TOKENIZER_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "xgrammar/xgrammar.h"
+
+namespace cxx_utils {
+
+// A process-wide registry of TokenizerInfo handles keyed by a content hash
+// of the data they were built from. TokenizerInfo is an immutable shared
+// handle, so storing one copy here and handing out further handle copies
+// lets any number of compilers and matchers reference the same decoded
+// vocabulary tables: identical tokenizers cost their memory once per
+// process instead of once per construction.
+//
+// Keys are computed on the Rust side from the construction inputs; the
+// registry itself only maps key -> shared handle under a mutex.
+
+struct TokenizerRegistry {
+  std::mutex mutex;
+  std::unordered_map<uint64_t, xgrammar::TokenizerInfo> entries;
+};
+
+inline TokenizerRegistry& tokenizer_registry() {
+  static TokenizerRegistry registry;
+  return registry;
+}
+
+// Returns a handle sharing the registered tokenizer, or null if the key is
+// not registered.
+inline std::unique_ptr<xgrammar::TokenizerInfo> tokenizer_registry_lookup(
+    uint64_t key
+) {
+  TokenizerRegistry& registry = tokenizer_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.entries.find(key);
+  if (it == registry.entries.end()) {
+    return nullptr;
+  }
+  return std::make_unique<xgrammar::TokenizerInfo>(it->second);
+}
+
+// Registers a handle copy of `info` under `key`. If the key is already
+// registered the existing entry wins, so concurrent constructions of the
+// same tokenizer converge on one shared copy.
+inline void tokenizer_registry_insert(
+    uint64_t key,
+    const xgrammar::TokenizerInfo& info
+) {
+  TokenizerRegistry& registry = tokenizer_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.entries.emplace(key, info);
+}
+
+inline size_t tokenizer_registry_size() {
+  TokenizerRegistry& registry = tokenizer_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.entries.size();
+}
+
+inline void tokenizer_registry_clear() {
+  TokenizerRegistry& registry = tokenizer_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.entries.clear();
+}
+
+} // namespace cxx_utils
+
+#endif // XGRAMMAR_RS_CXX_UTILS_TOKENIZER_REGISTRY_H_
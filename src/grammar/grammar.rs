@@ -321,6 +321,48 @@ impl Grammar {
         }
     }
 
+    /// Create a grammar that matches any of the grammars in the list, like
+    /// `union`, but deduplicating structurally identical inputs first.
+    ///
+    /// Tool catalogs routinely contain many tools whose grammars are
+    /// identical (shared JSON scaffolding, parameter-less tools); plain
+    /// `union` copies each one into the result, so the unioned grammar grows
+    /// with the full catalog and compiles sub-rules it already has. This
+    /// variant keeps the first occurrence of each distinct grammar
+    /// (identified by its serialized form) and unions only those, which
+    /// leaves the matched language unchanged — `A | A` is `A` — while the
+    /// result scales with the number of distinct grammars. The whole pass is
+    /// linear in the total catalog size.
+    ///
+    /// Deduplication is only sound for union, not `concat`: `A + A` matches
+    /// a different language than `A`.
+    ///
+    /// # Parameters
+    ///
+    /// - `grammars`: The grammars to create the union of.
+    ///
+    /// # Returns
+    ///
+    /// The union of the distinct grammars, in first-occurrence order.
+    pub fn union_deduped(grammars: &[Grammar]) -> Self {
+        assert!(!grammars.is_empty(), "union requires at least one grammar");
+        let mut seen = std::collections::HashSet::new();
+        let mut vec = ffi::new_grammar_vector();
+        {
+            let mut vec_pin = vec.pin_mut();
+            ffi::grammar_vec_reserve(vec_pin.as_mut(), grammars.len());
+            for g in grammars {
+                if seen.insert(g.serialize_json()) {
+                    ffi::grammar_vec_push(vec_pin.as_mut(), g.ffi_ref());
+                }
+            }
+        }
+        let ffi_ptr = ffi::grammar_union(vec.as_ref().unwrap());
+        Self {
+            inner: ffi_ptr,
+        }
+    }
+
     /// Serialize the grammar to a JSON string.
     ///
     /// # Returns
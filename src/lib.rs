@@ -203,6 +203,29 @@ mod ffi {
             error_out: *mut CxxString,
         ) -> UniquePtr<TokenizerInfo>;
 
+        pub unsafe fn make_tokenizer_info_from_packed(
+            buffer_ptr: *const c_char,
+            buffer_len: usize,
+            offsets_ptr: *const usize,
+            offsets_len: usize,
+            vocab_type: VocabType,
+            has_vocab_size: bool,
+            vocab_size: i32,
+            has_stop_ids: bool,
+            stop_token_ids_ptr: *const i32,
+            stop_token_ids_len: usize,
+            add_prefix_space: bool,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<TokenizerInfo>;
+
+        pub unsafe fn tokenizer_info_from_packed_vocab_and_metadata(
+            buffer_ptr: *const c_char,
+            buffer_len: usize,
+            offsets_ptr: *const usize,
+            offsets_len: usize,
+            metadata: &CxxString,
+        ) -> UniquePtr<TokenizerInfo>;
+
         pub unsafe fn tokenizer_info_deserialize_json_or_error(
             json_string: &CxxString,
             error_kind: *mut i32,
@@ -304,6 +327,10 @@ mod ffi {
             self_: &CompiledGrammar
         ) -> UniquePtr<CxxString>;
 
+        pub fn compiled_grammar_clone(
+            self_: &CompiledGrammar
+        ) -> UniquePtr<CompiledGrammar>;
+
         // cxx_utils/grammar_compiler.hpp
 
         pub unsafe fn make_grammar_compiler(
@@ -319,6 +346,10 @@ mod ffi {
             metadata: &CxxString,
         ) -> UniquePtr<TokenizerInfo>;
 
+        pub fn tokenizer_info_clone(
+            self_: &TokenizerInfo
+        ) -> UniquePtr<TokenizerInfo>;
+
         pub fn tokenizer_info_serialize_json(
             self_: &TokenizerInfo
         ) -> UniquePtr<CxxString>;
@@ -327,6 +358,19 @@ mod ffi {
             self_: &TokenizerInfo
         ) -> UniquePtr<CxxString>;
 
+        // cxx_utils/tokenizer_registry.hpp
+
+        pub fn tokenizer_registry_lookup(key: u64) -> UniquePtr<TokenizerInfo>;
+
+        pub fn tokenizer_registry_insert(
+            key: u64,
+            info: &TokenizerInfo,
+        );
+
+        pub fn tokenizer_registry_size() -> usize;
+
+        pub fn tokenizer_registry_clear();
+
         pub unsafe fn compiler_compile_json_schema(
             compiler: Pin<&mut GrammarCompiler>,
             schema: &CxxString,
@@ -365,6 +409,128 @@ mod ffi {
             error_out: *mut CxxString,
         ) -> UniquePtr<CompiledGrammar>;
 
+        // cxx_utils/compile_future.hpp
+
+        pub type CompileFuture;
+
+        pub unsafe fn compiler_compile_json_schema_async(
+            compiler: Pin<&mut GrammarCompiler>,
+            schema: &CxxString,
+            any_whitespace: bool,
+            has_indent: bool,
+            indent: i32,
+            has_separators: bool,
+            separator_comma: &CxxString,
+            separator_colon: &CxxString,
+            strict_mode: bool,
+            has_max_whitespace_cnt: bool,
+            max_whitespace_cnt: i32,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompileFuture>;
+
+        pub unsafe fn compiler_compile_builtin_json_async(
+            compiler: Pin<&mut GrammarCompiler>,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompileFuture>;
+
+        pub unsafe fn compiler_compile_regex_async(
+            compiler: Pin<&mut GrammarCompiler>,
+            regex: &CxxString,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompileFuture>;
+
+        pub unsafe fn compiler_compile_structural_tag_async(
+            compiler: Pin<&mut GrammarCompiler>,
+            structural_tag_json: &CxxString,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompileFuture>;
+
+        pub unsafe fn compiler_compile_grammar_async(
+            compiler: Pin<&mut GrammarCompiler>,
+            grammar: &Grammar,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompileFuture>;
+
+        pub fn compile_future_is_ready(future: &CompileFuture) -> bool;
+
+        pub unsafe fn compile_future_wait(
+            future: Pin<&mut CompileFuture>,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompiledGrammar>;
+
+        // cxx_utils/coalesce.hpp
+
+        pub type CompileCoalescer;
+
+        pub fn make_compile_coalescer() -> UniquePtr<CompileCoalescer>;
+
+        pub fn coalescer_coalesced_waits(self_: &CompileCoalescer) -> u64;
+
+        pub unsafe fn coalescer_compile_json_schema(
+            self_: Pin<&mut CompileCoalescer>,
+            compiler: Pin<&mut GrammarCompiler>,
+            key: u64,
+            schema: &CxxString,
+            any_whitespace: bool,
+            has_indent: bool,
+            indent: i32,
+            has_separators: bool,
+            separator_comma: &CxxString,
+            separator_colon: &CxxString,
+            strict_mode: bool,
+            has_max_whitespace_cnt: bool,
+            max_whitespace_cnt: i32,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompiledGrammar>;
+
+        pub unsafe fn coalescer_compile_json_schema_async(
+            self_: Pin<&mut CompileCoalescer>,
+            compiler: Pin<&mut GrammarCompiler>,
+            key: u64,
+            schema: &CxxString,
+            any_whitespace: bool,
+            has_indent: bool,
+            indent: i32,
+            has_separators: bool,
+            separator_comma: &CxxString,
+            separator_colon: &CxxString,
+            strict_mode: bool,
+            has_max_whitespace_cnt: bool,
+            max_whitespace_cnt: i32,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompileFuture>;
+
+        // cxx_utils/batch_compile.hpp
+
+        pub type BatchCompileResult;
+        pub fn size(self: &BatchCompileResult) -> usize;
+        pub fn is_ok(
+            self: &BatchCompileResult,
+            index: usize,
+        ) -> bool;
+
+        pub unsafe fn compiler_compile_json_schema_batch(
+            compiler: Pin<&mut GrammarCompiler>,
+            schemas: &CxxVector<CxxString>,
+            any_whitespace: bool,
+            has_indent: bool,
+            indent: i32,
+            has_separators: bool,
+            separator_comma: &CxxString,
+            separator_colon: &CxxString,
+            strict_mode: bool,
+            has_max_whitespace_cnt: bool,
+            max_whitespace_cnt: i32,
+            max_workers: i32,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<BatchCompileResult>;
+
+        pub unsafe fn batch_compile_result_take(
+            result: Pin<&mut BatchCompileResult>,
+            index: usize,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CompiledGrammar>;
+
         // cxx_utils/matcher.hpp
 
         pub unsafe fn make_grammar_matcher(
@@ -382,6 +548,18 @@ mod ffi {
             error_out: *mut CxxString,
         ) -> UniquePtr<BatchGrammarMatcher>;
 
+        pub unsafe fn batch_make_grammar_matchers(
+            compiled_grammar: &CompiledGrammar,
+            count: usize,
+            has_override_stop_tokens: bool,
+            override_stop_tokens_ptr: *const i32,
+            override_stop_tokens_len: usize,
+            terminate_without_stop_token: bool,
+            max_rollback_tokens: i32,
+            max_threads: i32,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CxxVector<GrammarMatcher>>;
+
         pub fn grammar_matcher_find_jump_forward_string(
             self_: Pin<&mut GrammarMatcher>
         ) -> UniquePtr<CxxString>;
@@ -397,10 +575,28 @@ mod ffi {
             debug_print: bool,
         ) -> bool;
 
+        pub unsafe fn grammar_matcher_replay_tokens_status(
+            self_: Pin<&mut GrammarMatcher>,
+            token_ids_ptr: *const i32,
+            token_ids_len: usize,
+        ) -> i32;
+
+        pub unsafe fn grammar_matcher_accept_bytes(
+            self_: Pin<&mut GrammarMatcher>,
+            input_ptr: *const c_char,
+            input_len: usize,
+            debug_print: bool,
+        ) -> bool;
+
         pub fn grammar_matcher_fork(
             self_: &GrammarMatcher
         ) -> UniquePtr<GrammarMatcher>;
 
+        pub fn grammar_matcher_restore(
+            self_: Pin<&mut GrammarMatcher>,
+            checkpoint: &GrammarMatcher,
+        );
+
         pub unsafe fn grammar_matcher_traverse_draft_tree(
             self_: Pin<&mut GrammarMatcher>,
             retrieve_next_token_r: *const DLTensor,
@@ -424,7 +620,69 @@ mod ffi {
             matcher: &GrammarMatcher,
         );
 
-        pub unsafe fn batch_matcher_batch_fill_next_token_bitmask(
+        pub fn grammar_matcher_fork_n(
+            self_: &GrammarMatcher,
+            n: usize,
+        ) -> UniquePtr<CxxVector<GrammarMatcher>>;
+
+        pub fn grammar_matcher_vec_take(
+            vec: Pin<&mut CxxVector<GrammarMatcher>>,
+            index: usize,
+        ) -> UniquePtr<GrammarMatcher>;
+
+        pub type DraftTreeBatch;
+
+        pub fn make_draft_tree_batch() -> UniquePtr<DraftTreeBatch>;
+
+        pub fn draft_tree_batch_reserve(
+            self_: Pin<&mut DraftTreeBatch>,
+            n: usize,
+        );
+
+        pub unsafe fn draft_tree_batch_push(
+            self_: Pin<&mut DraftTreeBatch>,
+            retrieve_next_token_r: *const DLTensor,
+            retrieve_next_sibling_r: *const DLTensor,
+            draft_tokens_r: *const DLTensor,
+            token_bitmask_r: *mut DLTensor,
+        );
+
+        pub unsafe fn batch_traverse_draft_tree_status(
+            matchers: *mut CxxVector<GrammarMatcher>,
+            batch: &DraftTreeBatch,
+            time_budget: f64,
+            max_threads: i32,
+            completed_out: *mut u8,
+        ) -> i32;
+
+        // cxx_utils/matcher_pipeline.hpp
+
+        pub type BatchMatcherPipeline;
+
+        pub unsafe fn make_batch_matcher_pipeline(
+            max_threads: i32,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<BatchMatcherPipeline>;
+
+        pub unsafe fn batch_matcher_pipeline_submit(
+            pipeline: Pin<&mut BatchMatcherPipeline>,
+            matchers: &CxxVector<GrammarMatcher>,
+            token_ids_ptr: *const i32,
+            token_ids_len: usize,
+            bitmask_r: *mut DLTensor,
+            has_indices: bool,
+            indices_ptr: *const i32,
+            indices_len: usize,
+            debug_print: bool,
+            error_out: *mut CxxString,
+        ) -> bool;
+
+        pub unsafe fn batch_matcher_pipeline_wait(
+            pipeline: Pin<&mut BatchMatcherPipeline>,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CxxVector<u8>>;
+
+        pub unsafe fn batch_fill_next_token_bitmask_status(
             batch_matcher: Pin<&mut BatchGrammarMatcher>,
             matchers: *mut CxxVector<GrammarMatcher>,
             bitmask_r: *mut DLTensor,
@@ -432,41 +690,75 @@ mod ffi {
             indices_ptr: *const i32,
             indices_len: usize,
             debug_print: bool,
-        );
+        ) -> i32;
 
-        pub unsafe fn batch_accept_token(
+        pub unsafe fn batch_accept_token_status(
             matchers: *mut CxxVector<GrammarMatcher>,
             token_ids_ptr: *const i32,
             token_ids_len: usize,
             debug_print: bool,
-        ) -> UniquePtr<CxxVector<u8>>;
+            accepted_out: *mut u8,
+        ) -> i32;
 
-        pub unsafe fn batch_accept_string(
+        pub unsafe fn batch_accept_string_status(
             matchers: *mut CxxVector<GrammarMatcher>,
             strings: &CxxVector<CxxString>,
             debug_print: bool,
-        ) -> UniquePtr<CxxVector<u8>>;
+            accepted_out: *mut u8,
+        ) -> i32;
 
-        pub unsafe fn batch_rollback(
+        pub unsafe fn batch_rollback_status(
             matchers: *mut CxxVector<GrammarMatcher>,
             num_tokens_ptr: *const i32,
             num_tokens_len: usize,
-        );
+        ) -> i32;
 
-        pub unsafe fn apply_token_bitmask_inplace_cpu(
+        pub unsafe fn batch_find_jump_forward_string(
+            matchers: *mut CxxVector<GrammarMatcher>,
+            has_indices: bool,
+            indices_ptr: *const i32,
+            indices_len: usize,
+            max_threads: i32,
+            arena_out: *mut CxxString,
+            error_out: *mut CxxString,
+        ) -> UniquePtr<CxxVector<usize>>;
+
+        pub unsafe fn apply_token_bitmask_inplace_cpu_status(
             logits_r: *mut DLTensor,
             bitmask_r: *const DLTensor,
             vocab_size: i32,
             has_indices: bool,
             indices_ptr: *const i32,
             indices_len: usize,
-            error_out: *mut CxxString,
-        ) -> bool;
+        ) -> i32;
+
+        pub unsafe fn apply_token_bitmask_inplace_status(
+            logits_r: *mut DLTensor,
+            bitmask_r: *const DLTensor,
+            vocab_size: i32,
+            has_indices: bool,
+            indices_ptr: *const i32,
+            indices_len: usize,
+        ) -> i32;
+
+        // cxx_utils/status.hpp
+
+        pub unsafe fn copy_status_detail(out: *mut CxxString);
 
         // cxx_utils/config.hpp
 
         pub fn GetSerializationVersion() -> UniquePtr<CxxString>;
 
+        // cxx_utils/bench.hpp
+
+        pub fn bench_ffi_noop();
+
+        pub unsafe fn bench_ffi_noop_status(
+            values_ptr: *const i32,
+            values_len: usize,
+            error_out: *mut CxxString,
+        ) -> bool;
+
         // cxx_utils/dlpack.hpp
         pub unsafe fn make_tensor(
             data: *mut c_void,
@@ -481,6 +773,9 @@ mod ffi {
     }
 
     // This block is unsafe because some functions in it are declared safe.
+    // Gated so size-sensitive builds (wasm32-wasi in particular) can drop
+    // the debug/test-only entry points from the binary.
+    #[cfg(feature = "testing-utils")]
     #[namespace = "cxx_utils"]
     unsafe extern "C++" {
         include!("cxx_utils/testing.hpp");
@@ -577,6 +872,8 @@ pub use ffi::GetBitmaskDLType as get_bitmask_dltype;
 pub use ffi::GetBitmaskSize as get_bitmask_size;
 /// Opaque type representing C/C++'s `void`
 pub use ffi::c_void;
+mod binary_format;
+mod bundle;
 mod compiler;
 mod config;
 mod dlpack;
@@ -586,9 +883,14 @@ mod matcher;
 mod tokenizer_info;
 mod utils;
 
+#[cfg(feature = "testing-utils")]
 pub mod testing;
 
-pub use compiler::{CompiledGrammar, GrammarCompiler};
+pub use bundle::{GrammarBundle, GrammarBundleBuilder};
+pub use compiler::{
+    CompileFuture, CompiledGrammar, GrammarCompiler,
+    live_compiled_grammar_bytes, live_compiled_grammar_count,
+};
 pub use config::{
     get_max_recursion_depth, get_serialization_version, set_max_recursion_depth,
 };
@@ -597,8 +899,13 @@ pub use dlpack::{DLDataTypeCode, DLDevice, DLDeviceType};
 pub use error::{DeserializeError, StructuralTagError};
 pub use grammar::{Grammar, StructuralTagItem};
 pub use matcher::{
-    BatchGrammarMatcher, GrammarMatcher, allocate_token_bitmask,
-    apply_token_bitmask_inplace_cpu, get_bitmask_shape, reset_token_bitmask,
+    BatchGrammarMatcher, BatchMatcherPipeline, GrammarMatcher,
+    JumpForwardStrings, MatcherCheckpoint, MatcherPool, MatcherSnapshot,
+    MatcherStats, PipelineStep, allocate_token_bitmask,
+    apply_token_bitmask_inplace, apply_token_bitmask_inplace_cpu,
+    bitmask_and_inplace, bitmask_andnot_inplace, bitmask_count_allowed,
+    bitmask_first_allowed, bitmask_iter_allowed, bitmask_next_allowed,
+    bitmask_or_inplace, get_bitmask_shape, reset_token_bitmask,
 };
 pub use tokenizer_info::{
     HfMetadata, TokenizerInfo, VocabType, detect_metadata_from_hf,
@@ -1,11 +1,17 @@
-use super::GrammarMatcher;
-use crate::{CxxUniquePtr, DLTensor, ffi, utils::bytes_as_c_char_ptr};
+use std::time::Instant;
+
+use super::{GrammarMatcher, MatcherStats};
+use crate::{
+    CxxUniquePtr, DLTensor, ffi,
+    utils::{bytes_as_c_char_ptr, status_to_result},
+};
 
 /// A batch version of `GrammarMatcher` that can fill the next token bitmask for multiple
 /// matchers in parallel. It utilizes multiple threads to speed up the computation. It is
 /// especially useful when the batch size is large.
 pub struct BatchGrammarMatcher {
     inner: CxxUniquePtr<ffi::BatchGrammarMatcher>,
+    stats: MatcherStats,
 }
 
 impl BatchGrammarMatcher {
@@ -32,6 +38,7 @@ impl BatchGrammarMatcher {
         }
         Ok(Self {
             inner: ffi_pin,
+            stats: MatcherStats::default(),
         })
     }
 
@@ -58,16 +65,17 @@ impl BatchGrammarMatcher {
     /// - `debug_print`: Whether to print information about generated bitmask.
     ///   Helpful for debugging.
     ///
-    /// # Panics
+    /// # Errors
     ///
-    /// If the bitmask is invalid (not on CPU, not int32, shape mismatch).
+    /// Returns an error if the bitmask is invalid (not on CPU, not int32,
+    /// shape mismatch) or the engine fails.
     pub fn batch_fill_next_token_bitmask(
         &mut self,
         matchers: &[GrammarMatcher],
         bitmask: &mut CxxUniquePtr<DLTensor>,
         indices: Option<&[i32]>,
         debug_print: bool,
-    ) {
+    ) -> Result<(), String> {
         let mut ffi_matcher_vec = ffi::new_grammar_matcher_vector();
         {
             let mut vec_pin = ffi_matcher_vec.pin_mut();
@@ -87,8 +95,9 @@ impl BatchGrammarMatcher {
             _ => (false, std::ptr::null(), 0usize),
         };
 
-        unsafe {
-            ffi::batch_matcher_batch_fill_next_token_bitmask(
+        let start = Instant::now();
+        let code = unsafe {
+            ffi::batch_fill_next_token_bitmask_status(
                 self.inner.as_mut().expect("BatchGrammarMatcher inner is null"),
                 ffi_matcher_vec.as_mut().unwrap().get_unchecked_mut(),
                 bitmask.as_mut_ptr(),
@@ -96,8 +105,26 @@ impl BatchGrammarMatcher {
                 indices_ptr,
                 indices_len,
                 debug_print,
-            );
-        }
+            )
+        };
+        self.stats.fill_bitmask_ns += start.elapsed().as_nanos() as u64;
+        self.stats.fill_bitmask_calls += 1;
+        status_to_result(code)
+    }
+
+    /// The cumulative performance counters of this batch matcher, aggregated
+    /// over all matchers it has served. Only `batch_fill_next_token_bitmask`
+    /// updates them (one call counts once, covering the whole batch); the
+    /// associated-function batch operations have no instance to record into,
+    /// so token accept and rollback counters live on the individual
+    /// [`GrammarMatcher`]s.
+    pub fn stats(&self) -> MatcherStats {
+        self.stats
+    }
+
+    /// Reset the performance counters to zero.
+    pub fn reset_stats(&mut self) {
+        self.stats = MatcherStats::default();
     }
 
     /// Accept a batch of tokens for multiple matchers.
@@ -114,6 +141,11 @@ impl BatchGrammarMatcher {
     /// A list of booleans indicating whether each token was accepted by its corresponding
     /// matcher.
     ///
+    /// # Errors
+    ///
+    /// Returns an error if the engine fails; per-matcher rejections are not
+    /// errors and show up as `false` entries in the result.
+    ///
     /// # Panics
     ///
     /// If the sizes of `matchers` and `tokens` do not match.
@@ -121,7 +153,7 @@ impl BatchGrammarMatcher {
         matchers: &[GrammarMatcher],
         tokens: &[i32],
         debug_print: bool,
-    ) -> Box<[bool]> {
+    ) -> Result<Box<[bool]>, String> {
         assert_eq!(
             matchers.len(),
             tokens.len(),
@@ -140,16 +172,23 @@ impl BatchGrammarMatcher {
             }
         }
 
-        let result = unsafe {
-            ffi::batch_accept_token(
+        let mut accepted = vec![0u8; tokens.len()];
+        let code = unsafe {
+            ffi::batch_accept_token_status(
                 ffi_matcher_vec.as_mut().unwrap().get_unchecked_mut(),
                 tokens.as_ptr(),
                 tokens.len(),
                 debug_print,
+                accepted.as_mut_ptr(),
             )
         };
+        status_to_result(code)?;
 
-        result.iter().map(|&b| b != 0).collect::<Vec<_>>().into_boxed_slice()
+        Ok(accepted
+            .iter()
+            .map(|&b| b != 0)
+            .collect::<Vec<_>>()
+            .into_boxed_slice())
     }
 
     /// Accept a batch of strings for multiple matchers.
@@ -166,6 +205,11 @@ impl BatchGrammarMatcher {
     /// A list of booleans indicating whether each string was accepted by its corresponding
     /// matcher.
     ///
+    /// # Errors
+    ///
+    /// Returns an error if the engine fails; per-matcher rejections are not
+    /// errors and show up as `false` entries in the result.
+    ///
     /// # Panics
     ///
     /// If the sizes of `matchers` and `strings` do not match.
@@ -173,7 +217,7 @@ impl BatchGrammarMatcher {
         matchers: &[GrammarMatcher],
         strings: &[impl AsRef<str>],
         debug_print: bool,
-    ) -> Box<[bool]> {
+    ) -> Result<Box<[bool]>, String> {
         assert_eq!(
             matchers.len(),
             strings.len(),
@@ -208,23 +252,223 @@ impl BatchGrammarMatcher {
             }
         }
 
-        let result = unsafe {
-            ffi::batch_accept_string(
+        let mut accepted = vec![0u8; strings.len()];
+        let code = unsafe {
+            ffi::batch_accept_string_status(
                 ffi_matcher_vec.as_mut().unwrap().get_unchecked_mut(),
                 cxx_strings.as_ref().unwrap(),
                 debug_print,
+                accepted.as_mut_ptr(),
+            )
+        };
+        status_to_result(code)?;
+
+        Ok(accepted
+            .iter()
+            .map(|&b| b != 0)
+            .collect::<Vec<_>>()
+            .into_boxed_slice())
+    }
+
+    /// Compute the jump-forward strings of multiple matchers in one call,
+    /// writing them into a caller-provided [`JumpForwardStrings`] buffer.
+    ///
+    /// This is the companion of `batch_fill_next_token_bitmask` for
+    /// jump-forward decoding: instead of one FFI call and one string
+    /// allocation per sequence, the whole batch costs a single crossing and
+    /// the results land in `out`'s arena, whose capacity is reused across
+    /// calls — the steady state allocates nothing.
+    ///
+    /// # Parameters
+    ///
+    /// - `matchers`: The list of matchers to compute jump-forward strings
+    ///   for.
+    /// - `indices`: Which matchers to process; `None` processes
+    ///   `[0..matchers.len())`. `out` holds one entry per processed matcher,
+    ///   in `indices` order.
+    /// - `max_threads`: The maximum number of threads to use. If -1, it is
+    ///   set to `std::thread::hardware_concurrency() / 2`.
+    /// - `out`: The buffer receiving the strings; its previous contents are
+    ///   replaced.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the computation fails.
+    pub fn batch_find_jump_forward_string(
+        matchers: &[GrammarMatcher],
+        indices: Option<&[i32]>,
+        max_threads: i32,
+        out: &mut JumpForwardStrings,
+    ) -> Result<(), String> {
+        let mut ffi_matcher_vec = ffi::new_grammar_matcher_vector();
+        {
+            let mut vec_pin = ffi_matcher_vec.pin_mut();
+            ffi::grammar_matcher_vec_reserve(vec_pin.as_mut(), matchers.len());
+            for matcher in matchers {
+                ffi::grammar_matcher_vec_push(
+                    vec_pin.as_mut(),
+                    matcher.ffi_ref(),
+                );
+            }
+        }
+
+        let (has_indices, indices_ptr, indices_len) = match indices {
+            Some(slice) if !slice.is_empty() => {
+                (true, slice.as_ptr(), slice.len())
+            },
+            _ => (false, std::ptr::null(), 0usize),
+        };
+
+        cxx::let_cxx_string!(arena_out_cxx = "");
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let offsets = unsafe {
+            ffi::batch_find_jump_forward_string(
+                ffi_matcher_vec.as_mut().unwrap().get_unchecked_mut(),
+                has_indices,
+                indices_ptr,
+                indices_len,
+                max_threads,
+                arena_out_cxx.as_mut().get_unchecked_mut(),
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if offsets.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        out.arena.clear();
+        out.arena.extend_from_slice(arena_out_cxx.as_bytes());
+        out.offsets.clear();
+        out.offsets.extend(offsets.iter().copied());
+        Ok(())
+    }
+
+    /// Traverse the draft token trees of multiple sequences in one call,
+    /// filling each sequence's token bitmask. The per-sequence traversals
+    /// are independent, so they are fanned out across worker threads pulling
+    /// from a shared work queue instead of being serialized through one FFI
+    /// call per matcher.
+    ///
+    /// `time_budget` is one deadline in seconds shared by the whole batch:
+    /// each traversal runs with whatever budget remains when a worker picks
+    /// it up. Sequences that hit the deadline (or never start because it has
+    /// already passed) get `false` in the result and should fall back to
+    /// per-token validation — they are not errors and the bitmask rows of
+    /// completed sequences remain valid. `time_budget <= 0.0` disables the
+    /// deadline. Matcher states are not changed.
+    ///
+    /// # Parameters
+    ///
+    /// - `matchers`: The matchers to traverse, one per sequence.
+    /// - `retrieve_next_token`, `retrieve_next_sibling`, `draft_tokens`: The
+    ///   per-sequence draft-tree tensors, with the same layout
+    ///   `GrammarMatcher::traverse_draft_tree` takes.
+    /// - `token_bitmasks`: The per-sequence bitmask tensors to fill, one row
+    ///   per draft-tree node.
+    /// - `time_budget`: The shared deadline in seconds; `<= 0.0` disables it.
+    /// - `max_threads`: The maximum number of threads to use. If -1, it is
+    ///   set to `std::thread::hardware_concurrency() / 2`.
+    ///
+    /// # Returns
+    ///
+    /// One flag per sequence: `true` if its tree was fully traversed,
+    /// `false` if it timed out.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if any traversal fails (e.g. a tensor has the wrong
+    /// shape or dtype); timeouts are not errors.
+    ///
+    /// # Panics
+    ///
+    /// If the tensor slices and `matchers` do not all have the same length.
+    pub fn batch_traverse_draft_tree(
+        matchers: &[GrammarMatcher],
+        retrieve_next_token: &[&DLTensor],
+        retrieve_next_sibling: &[&DLTensor],
+        draft_tokens: &[&DLTensor],
+        token_bitmasks: &mut [&mut CxxUniquePtr<DLTensor>],
+        time_budget: f64,
+        max_threads: i32,
+    ) -> Result<Box<[bool]>, String> {
+        assert_eq!(
+            matchers.len(),
+            retrieve_next_token.len(),
+            "matchers and retrieve_next_token must have the same length"
+        );
+        assert_eq!(
+            matchers.len(),
+            retrieve_next_sibling.len(),
+            "matchers and retrieve_next_sibling must have the same length"
+        );
+        assert_eq!(
+            matchers.len(),
+            draft_tokens.len(),
+            "matchers and draft_tokens must have the same length"
+        );
+        assert_eq!(
+            matchers.len(),
+            token_bitmasks.len(),
+            "matchers and token_bitmasks must have the same length"
+        );
+
+        let mut ffi_matcher_vec = ffi::new_grammar_matcher_vector();
+        {
+            let mut vec_pin = ffi_matcher_vec.pin_mut();
+            ffi::grammar_matcher_vec_reserve(vec_pin.as_mut(), matchers.len());
+            for matcher in matchers {
+                ffi::grammar_matcher_vec_push(
+                    vec_pin.as_mut(),
+                    matcher.ffi_ref(),
+                );
+            }
+        }
+
+        let mut ffi_batch = ffi::make_draft_tree_batch();
+        {
+            let mut batch_pin = ffi_batch.pin_mut();
+            ffi::draft_tree_batch_reserve(batch_pin.as_mut(), matchers.len());
+            for i in 0..matchers.len() {
+                unsafe {
+                    ffi::draft_tree_batch_push(
+                        batch_pin.as_mut(),
+                        retrieve_next_token[i] as *const _,
+                        retrieve_next_sibling[i] as *const _,
+                        draft_tokens[i] as *const _,
+                        token_bitmasks[i].as_mut_ptr(),
+                    );
+                }
+            }
+        }
+
+        let mut completed = vec![0u8; matchers.len()];
+        let code = unsafe {
+            ffi::batch_traverse_draft_tree_status(
+                ffi_matcher_vec.as_mut().unwrap().get_unchecked_mut(),
+                ffi_batch.as_ref().unwrap(),
+                time_budget,
+                max_threads,
+                completed.as_mut_ptr(),
             )
         };
+        status_to_result(code)?;
 
-        result.iter().map(|&b| b != 0).collect::<Vec<_>>().into_boxed_slice()
+        Ok(completed
+            .iter()
+            .map(|&b| b != 0)
+            .collect::<Vec<_>>()
+            .into_boxed_slice())
     }
 
     /// Roll back each matcher by the corresponding number of tokens. Panics if the slice lengths
     /// differ.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the engine fails.
     pub fn batch_rollback(
         matchers: &[GrammarMatcher],
         num_tokens: &[i32],
-    ) {
+    ) -> Result<(), String> {
         assert_eq!(
             matchers.len(),
             num_tokens.len(),
@@ -243,12 +487,67 @@ impl BatchGrammarMatcher {
             }
         }
 
-        unsafe {
-            ffi::batch_rollback(
+        let code = unsafe {
+            ffi::batch_rollback_status(
                 ffi_matcher_vec.as_mut().unwrap().get_unchecked_mut(),
                 num_tokens.as_ptr(),
                 num_tokens.len(),
-            );
+            )
+        };
+        status_to_result(code)
+    }
+}
+
+impl Drop for BatchGrammarMatcher {
+    fn drop(&mut self) {}
+}
+
+/// The jump-forward strings of one batch, packed into a single arena buffer
+/// plus an offsets table. Entry `i` spans
+/// `arena[offsets[i]..offsets[i + 1]]`. Reusing one instance across decode
+/// steps keeps the arena capacity, so refilling it allocates nothing in the
+/// steady state.
+///
+/// Entries are byte slices: a jump-forward string can end in the middle of a
+/// multi-byte character, so it is not guaranteed to be valid UTF-8 on its
+/// own.
+#[derive(Clone, Debug, Default)]
+pub struct JumpForwardStrings {
+    arena: Vec<u8>,
+    offsets: Vec<usize>,
+}
+
+impl JumpForwardStrings {
+    /// Create an empty buffer. It is filled by
+    /// [`BatchGrammarMatcher::batch_find_jump_forward_string`].
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// The number of entries.
+    pub fn len(&self) -> usize {
+        self.offsets.len().saturating_sub(1)
+    }
+
+    /// Whether there are no entries.
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// The jump-forward string of entry `index`, or `None` if out of range.
+    pub fn get(
+        &self,
+        index: usize,
+    ) -> Option<&[u8]> {
+        if index + 1 >= self.offsets.len() {
+            return None;
         }
+        Some(&self.arena[self.offsets[index]..self.offsets[index + 1]])
+    }
+
+    /// Iterate over all entries in order.
+    pub fn iter(&self) -> impl Iterator<Item = &[u8]> {
+        (0..self.len())
+            .map(|i| &self.arena[self.offsets[i]..self.offsets[i + 1]])
     }
 }
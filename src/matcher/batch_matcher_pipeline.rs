@@ -0,0 +1,198 @@
+use super::GrammarMatcher;
+use crate::{CxxUniquePtr, DLTensor, ffi};
+
+/// A double-buffered pipeline around `BatchGrammarMatcher`.
+///
+/// One decode step is submitted as "accept these tokens, then fill the
+/// next-token bitmask into this tensor" and runs on a persistent background
+/// thread, so the batch fill for step `t + 1` overlaps the forward pass of
+/// step `t` instead of running between sampling steps. The intended usage
+/// alternates two bitmask tensors:
+///
+/// 1. `submit` the accepted tokens of step `t` with bitmask buffer B.
+/// 2. Launch the forward pass of step `t` using the already-filled buffer A.
+/// 3. `wait` for the fill, sample step `t + 1` from buffer B, and swap.
+///
+/// At most one step can be in flight. `submit` returns a [`PipelineStep`]
+/// guard that exclusively borrows the matchers and the bitmask tensor while
+/// the background thread updates them, so the borrow checker rules out
+/// touching (or dropping) them before the step completes.
+pub struct BatchMatcherPipeline {
+    inner: CxxUniquePtr<ffi::BatchMatcherPipeline>,
+}
+
+/// An in-flight pipeline step returned by [`BatchMatcherPipeline::submit`].
+///
+/// While this guard is alive, the background thread owns the submitted
+/// matchers' shared state and the bitmask tensor; the guard's borrows keep
+/// safe code from using them concurrently. [`PipelineStep::wait`] consumes
+/// the guard and returns the step's results. Dropping the guard without
+/// calling `wait` blocks until the step finishes and discards the results,
+/// so the borrows never outlive the background work.
+pub struct PipelineStep<'a> {
+    pipeline: &'a mut BatchMatcherPipeline,
+    finished: bool,
+    _matchers: &'a mut [GrammarMatcher],
+    _bitmask: &'a mut CxxUniquePtr<DLTensor>,
+}
+
+impl PipelineStep<'_> {
+    /// Block until the step finishes and return whether each token was
+    /// accepted by its corresponding matcher. After this returns, the
+    /// bitmask tensor passed to `submit` is filled and safe to use.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the step failed.
+    pub fn wait(mut self) -> Result<Box<[bool]>, String> {
+        self.finished = true;
+        self.pipeline.wait_inner()
+    }
+}
+
+impl Drop for PipelineStep<'_> {
+    fn drop(&mut self) {
+        if !self.finished {
+            let _ = self.pipeline.wait_inner();
+        }
+    }
+}
+
+impl BatchMatcherPipeline {
+    /// Construct the pipeline.
+    ///
+    /// # Parameters
+    ///
+    /// - `max_threads`: The maximum number of threads used for the batch
+    ///   fill, as in `BatchGrammarMatcher::new`.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the pipeline cannot be constructed.
+    pub fn new(max_threads: i32) -> Result<Self, String> {
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let inner = unsafe {
+            ffi::make_batch_matcher_pipeline(
+                max_threads,
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if inner.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(Self {
+            inner,
+        })
+    }
+
+    /// Start one pipeline step in the background: accept `tokens` on the
+    /// matchers, then fill `bitmask` with the next-token bitmask.
+    ///
+    /// The returned [`PipelineStep`] guard borrows `matchers` and `bitmask`
+    /// exclusively until the step completes; call [`PipelineStep::wait`] to
+    /// collect the results and release them.
+    ///
+    /// # Parameters
+    ///
+    /// - `matchers`: The list of matchers; one token is accepted per matcher.
+    /// - `tokens`: The token accepted by each matcher.
+    /// - `bitmask`: The bitmask tensor to fill, as in
+    ///   `batch_fill_next_token_bitmask`.
+    /// - `indices`: Which bitmask rows to fill; `None` fills
+    ///   `[0..matchers.len())`.
+    /// - `debug_print`: Whether to print debug information.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if a step is already in flight.
+    ///
+    /// # Panics
+    ///
+    /// If the sizes of `matchers` and `tokens` do not match.
+    pub fn submit<'a>(
+        &'a mut self,
+        matchers: &'a mut [GrammarMatcher],
+        tokens: &[i32],
+        bitmask: &'a mut CxxUniquePtr<DLTensor>,
+        indices: Option<&[i32]>,
+        debug_print: bool,
+    ) -> Result<PipelineStep<'a>, String> {
+        assert_eq!(
+            matchers.len(),
+            tokens.len(),
+            "matchers and tokens must have the same length"
+        );
+
+        let mut ffi_matcher_vec = ffi::new_grammar_matcher_vector();
+        {
+            let mut vec_pin = ffi_matcher_vec.pin_mut();
+            ffi::grammar_matcher_vec_reserve(vec_pin.as_mut(), matchers.len());
+            for matcher in matchers.iter() {
+                ffi::grammar_matcher_vec_push(
+                    vec_pin.as_mut(),
+                    matcher.ffi_ref(),
+                );
+            }
+        }
+
+        let (has_indices, indices_ptr, indices_len) = match indices {
+            Some(slice) if !slice.is_empty() => {
+                (true, slice.as_ptr(), slice.len())
+            },
+            _ => (false, std::ptr::null(), 0usize),
+        };
+
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let ok = unsafe {
+            ffi::batch_matcher_pipeline_submit(
+                self.inner
+                    .as_mut()
+                    .expect("BatchMatcherPipeline inner is null"),
+                ffi_matcher_vec.as_ref().unwrap(),
+                tokens.as_ptr(),
+                tokens.len(),
+                bitmask.as_mut_ptr(),
+                has_indices,
+                indices_ptr,
+                indices_len,
+                debug_print,
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if !ok {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(PipelineStep {
+            pipeline: self,
+            finished: false,
+            _matchers: matchers,
+            _bitmask: bitmask,
+        })
+    }
+
+    /// Block until the in-flight step finishes and return whether each token
+    /// was accepted by its corresponding matcher.
+    fn wait_inner(&mut self) -> Result<Box<[bool]>, String> {
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let result = unsafe {
+            ffi::batch_matcher_pipeline_wait(
+                self.inner
+                    .as_mut()
+                    .expect("BatchMatcherPipeline inner is null"),
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if result.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok(result
+            .iter()
+            .map(|&b| b != 0)
+            .collect::<Vec<_>>()
+            .into_boxed_slice())
+    }
+}
+
+impl Drop for BatchMatcherPipeline {
+    fn drop(&mut self) {}
+}
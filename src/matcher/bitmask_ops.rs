@@ -0,0 +1,194 @@
+//! Word-wise utilities for token bitmask rows.
+//!
+//! `allocate_token_bitmask` hands callers raw `i32` buffers, and serving
+//! stacks routinely combine the grammar mask with their own masks (ban
+//! lists, allow lists), count the allowed tokens to detect forced-token
+//! states, or walk the allowed set for logging. These helpers cover those
+//! operations on whole rows at memory bandwidth: the loops are plain
+//! word-wise passes over contiguous slices, which the compiler vectorizes
+//! for the target in use, so no FFI crossing is involved. The one target
+//! with explicit kernels is `wasm32` with the `simd128` feature, where the
+//! backend does not reliably auto-vectorize and in-browser masking budgets
+//! are tightest; see the `simd128` module at the bottom.
+//!
+//! All functions operate on a single bitmask row (`ceil(vocab_size / 32)`
+//! words, as returned by `get_bitmask_shape`). For a batched buffer, slice
+//! out the row first. Following the engine's convention, a set bit allows
+//! the token and a cleared bit masks it; bits at positions `>= vocab_size`
+//! in the last word are ignored by the counting and search helpers.
+
+/// Intersect `dst` with `src` in place: a token stays allowed only if both
+/// masks allow it. This is the merge for combining the grammar mask with a
+/// business-rule allow mask.
+///
+/// # Panics
+///
+/// If the slices have different lengths.
+pub fn bitmask_and_inplace(
+    dst: &mut [i32],
+    src: &[i32],
+) {
+    assert_eq!(dst.len(), src.len(), "bitmask rows must have the same length");
+    #[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+    simd128::and_inplace(dst, src);
+    #[cfg(not(all(target_arch = "wasm32", target_feature = "simd128")))]
+    for (d, s) in dst.iter_mut().zip(src) {
+        *d &= s;
+    }
+}
+
+/// Union `src` into `dst` in place: a token is allowed if either mask
+/// allows it.
+///
+/// # Panics
+///
+/// If the slices have different lengths.
+pub fn bitmask_or_inplace(
+    dst: &mut [i32],
+    src: &[i32],
+) {
+    assert_eq!(dst.len(), src.len(), "bitmask rows must have the same length");
+    #[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+    simd128::or_inplace(dst, src);
+    #[cfg(not(all(target_arch = "wasm32", target_feature = "simd128")))]
+    for (d, s) in dst.iter_mut().zip(src) {
+        *d |= s;
+    }
+}
+
+/// Clear every token of `dst` that `src` allows: `dst &= !src`. With `src`
+/// as a ban list whose set bits mark banned tokens, this removes the banned
+/// tokens from the grammar mask.
+///
+/// # Panics
+///
+/// If the slices have different lengths.
+pub fn bitmask_andnot_inplace(
+    dst: &mut [i32],
+    src: &[i32],
+) {
+    assert_eq!(dst.len(), src.len(), "bitmask rows must have the same length");
+    #[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+    simd128::andnot_inplace(dst, src);
+    #[cfg(not(all(target_arch = "wasm32", target_feature = "simd128")))]
+    for (d, s) in dst.iter_mut().zip(src) {
+        *d &= !s;
+    }
+}
+
+/// Mask off the bits of the last word that lie beyond `vocab_size`, and
+/// report how many whole words cover the vocabulary.
+fn tail_masked_words(
+    mask: &[i32],
+    vocab_size: usize,
+) -> (usize, i32) {
+    let full_words = vocab_size / 32;
+    let tail_bits = vocab_size % 32;
+    let tail = if tail_bits == 0 || full_words >= mask.len() {
+        0
+    } else {
+        mask[full_words] & ((1i32 << tail_bits) - 1)
+    };
+    (full_words.min(mask.len()), tail)
+}
+
+/// Count the allowed tokens in the first `vocab_size` positions of a mask
+/// row. A count of 1 means the next token is forced; 0 means the matcher
+/// has no valid continuation.
+pub fn bitmask_count_allowed(
+    mask: &[i32],
+    vocab_size: usize,
+) -> usize {
+    let (full_words, tail) = tail_masked_words(mask, vocab_size);
+    mask[..full_words].iter().map(|w| w.count_ones() as usize).sum::<usize>()
+        + tail.count_ones() as usize
+}
+
+/// The lowest allowed token id at position `start` or later, or `None` if
+/// no token from `start` to `vocab_size` is allowed. `start = 0` finds the
+/// first allowed token; passing `previous + 1` walks the allowed set.
+pub fn bitmask_next_allowed(
+    mask: &[i32],
+    vocab_size: usize,
+    start: usize,
+) -> Option<usize> {
+    if start >= vocab_size {
+        return None;
+    }
+    let mut word_index = start / 32;
+    // Clear the bits below `start` in its word, then scan word by word.
+    let mut word = mask.get(word_index).copied().unwrap_or(0)
+        & (u32::MAX << (start % 32)) as i32;
+    loop {
+        if word != 0 {
+            let token = word_index * 32 + word.trailing_zeros() as usize;
+            return (token < vocab_size).then_some(token);
+        }
+        word_index += 1;
+        if word_index * 32 >= vocab_size || word_index >= mask.len() {
+            return None;
+        }
+        word = mask[word_index];
+    }
+}
+
+/// The lowest allowed token id, or `None` if the mask allows nothing.
+pub fn bitmask_first_allowed(
+    mask: &[i32],
+    vocab_size: usize,
+) -> Option<usize> {
+    bitmask_next_allowed(mask, vocab_size, 0)
+}
+
+/// Iterate over all allowed token ids of a mask row in increasing order.
+pub fn bitmask_iter_allowed<'a>(
+    mask: &'a [i32],
+    vocab_size: usize,
+) -> impl Iterator<Item = usize> + 'a {
+    let mut next = bitmask_first_allowed(mask, vocab_size);
+    std::iter::from_fn(move || {
+        let current = next?;
+        next = bitmask_next_allowed(mask, vocab_size, current + 1);
+        Some(current)
+    })
+}
+
+// Explicit SIMD128 lowering of the merge loops for `wasm32` builds with
+// the `simd128` target feature, processing four mask words per
+// instruction. `v128_load`/`v128_store` are unaligned accesses, so the
+// slices need no alignment guarantee; the last `len % 4` words fall back
+// to the scalar loop.
+#[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+mod simd128 {
+    use core::arch::wasm32::{
+        v128, v128_and, v128_andnot, v128_load, v128_or, v128_store,
+    };
+
+    macro_rules! merge_inplace {
+        ($name:ident, $vector_op:ident, $scalar:expr) => {
+            pub(super) fn $name(
+                dst: &mut [i32],
+                src: &[i32],
+            ) {
+                let vector_words = dst.len() & !3;
+                for i in (0..vector_words).step_by(4) {
+                    // SAFETY: `i + 3 < dst.len() == src.len()`, and the
+                    // loads and stores are unaligned.
+                    unsafe {
+                        let d = dst.as_mut_ptr().add(i).cast::<v128>();
+                        let s = src.as_ptr().add(i).cast::<v128>();
+                        v128_store(d, $vector_op(v128_load(d), v128_load(s)));
+                    }
+                }
+                for i in vector_words..dst.len() {
+                    dst[i] = $scalar(dst[i], src[i]);
+                }
+            }
+        };
+    }
+
+    merge_inplace!(and_inplace, v128_and, |d: i32, s: i32| d & s);
+    merge_inplace!(or_inplace, v128_or, |d: i32, s: i32| d | s);
+    // `v128_andnot(a, b)` computes `a & !b`, matching `dst &= !src`.
+    merge_inplace!(andnot_inplace, v128_andnot, |d: i32, s: i32| d & !s);
+}
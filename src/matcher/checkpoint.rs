@@ -0,0 +1,21 @@
+use crate::{CxxUniquePtr, ffi};
+
+/// An owned branch point captured from a live [`super::GrammarMatcher`].
+///
+/// Beam search and backtracking samplers restore to a handful of branch
+/// points, not to arbitrary depths, so paying per-token rollback history is
+/// waste: a deep [`super::GrammarMatcher::rollback`] rewinds token by token.
+/// A checkpoint instead holds an independent copy of the matcher state taken
+/// at the branch point, and restoring swaps it back in at a cost that does
+/// not depend on how many tokens were accepted since — O(1) when the
+/// checkpoint is consumed, one engine-side state copy when it is kept for
+/// further restores.
+///
+/// A checkpoint is only meaningful for the matcher it was taken from (or one
+/// of its forks): it captures engine state, not the construction options, so
+/// restoring it onto a matcher built over a different compiled grammar is a
+/// logic error.
+pub struct MatcherCheckpoint {
+    pub(crate) inner: CxxUniquePtr<ffi::GrammarMatcher>,
+    pub(crate) token_history: Option<Vec<i32>>,
+}
@@ -1,6 +1,12 @@
-use std::pin::Pin;
+use std::{pin::Pin, time::Instant};
 
-use crate::{CxxUniquePtr, DLTensor, compiler::CompiledGrammar, ffi};
+use super::{MatcherCheckpoint, MatcherSnapshot, MatcherStats};
+use crate::{
+    CxxUniquePtr, DLTensor,
+    compiler::CompiledGrammar,
+    ffi,
+    utils::{bytes_as_c_char_ptr, status_to_result},
+};
 
 /// Match the output of the LLM to the specified grammar, then generate the mask for the next
 /// token. This is the core class in the grammar-guided generation.
@@ -20,6 +26,14 @@ use crate::{CxxUniquePtr, DLTensor, compiler::CompiledGrammar, ffi};
 pub struct GrammarMatcher {
     inner: CxxUniquePtr<ffi::GrammarMatcher>,
     stored_stop_token_ids: Box<[i32]>,
+    override_stop_tokens: Option<Box<[i32]>>,
+    terminate_without_stop_token: bool,
+    max_rollback_tokens: i32,
+    // The accepted-token history while the state is reconstructible from
+    // token operations alone; `None` once `accept_string`/`accept_bytes`
+    // changed the state, which disables `snapshot` until the next `reset`.
+    token_history: Option<Vec<i32>>,
+    stats: MatcherStats,
 }
 
 impl GrammarMatcher {
@@ -74,9 +88,103 @@ impl GrammarMatcher {
         Ok(Self {
             inner: unique_ptr,
             stored_stop_token_ids,
+            override_stop_tokens: override_stop_tokens
+                .map(|slice| slice.to_vec().into_boxed_slice()),
+            terminate_without_stop_token,
+            max_rollback_tokens,
+            token_history: Some(Vec::new()),
+            stats: MatcherStats::default(),
         })
     }
 
+    /// Construct `count` matchers over one compiled grammar in a single
+    /// call.
+    ///
+    /// Equivalent to calling [`Self::new`] `count` times with the same
+    /// arguments, but the whole batch costs one FFI crossing and matcher
+    /// initialization is spread over up to `max_threads` threads, which
+    /// shortens time-to-first-token when a large batch of sequences shares
+    /// one grammar. The compiled grammar is shared between all matchers.
+    ///
+    /// # Parameters
+    ///
+    /// - `compiled_grammar`: The initialization context for the grammar matchers.
+    /// - `override_stop_tokens`: If not `None`, the stop tokens to override the ones in
+    ///   the grammar.
+    /// - `terminate_without_stop_token`: Whether to terminate the matchers without accepting
+    ///   a stop token.
+    /// - `max_rollback_tokens`: Deprecated. You don't need to set it and it's always unlimited
+    ///   (-1).
+    /// - `count`: The number of matchers to construct.
+    /// - `max_threads`: The maximum number of threads to use. If -1, it is
+    ///   set to `std::thread::hardware_concurrency() / 2`.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if any of the grammar matchers cannot be
+    /// constructed.
+    pub fn new_batch(
+        compiled_grammar: &CompiledGrammar,
+        override_stop_tokens: Option<&[i32]>,
+        terminate_without_stop_token: bool,
+        max_rollback_tokens: i32,
+        count: usize,
+        max_threads: i32,
+    ) -> Result<Vec<Self>, String> {
+        let stored_stop_token_ids: Box<[i32]> = match override_stop_tokens {
+            Some(slice) => slice.to_vec().into_boxed_slice(),
+            None => compiled_grammar.tokenizer_info().stop_token_ids(),
+        };
+        let (has_override, ptr, len) = match override_stop_tokens {
+            Some(slice) if !slice.is_empty() => {
+                (true, slice.as_ptr(), slice.len())
+            },
+            _ => (false, std::ptr::null(), 0usize),
+        };
+
+        cxx::let_cxx_string!(error_out_cxx = "");
+        let mut matchers_cxx = unsafe {
+            ffi::batch_make_grammar_matchers(
+                compiled_grammar.ffi_ref(),
+                count,
+                has_override,
+                ptr,
+                len,
+                terminate_without_stop_token,
+                max_rollback_tokens,
+                max_threads,
+                error_out_cxx.as_mut().get_unchecked_mut(),
+            )
+        };
+        if matchers_cxx.is_null() {
+            return Err(error_out_cxx.to_string());
+        }
+        Ok((0..count)
+            .map(|i| {
+                let inner = ffi::grammar_matcher_vec_take(
+                    matchers_cxx
+                        .as_mut()
+                        .expect("constructed matcher vector is null"),
+                    i,
+                );
+                assert!(
+                    !inner.is_null(),
+                    "constructed matcher index out of range"
+                );
+                Self {
+                    inner,
+                    stored_stop_token_ids: stored_stop_token_ids.clone(),
+                    override_stop_tokens: override_stop_tokens
+                        .map(|slice| slice.to_vec().into_boxed_slice()),
+                    terminate_without_stop_token,
+                    max_rollback_tokens,
+                    token_history: Some(Vec::new()),
+                    stats: MatcherStats::default(),
+                }
+            })
+            .collect())
+    }
+
     /// Accept one token and update the state of the matcher.
     ///
     /// In the following cases, the matcher will not accept the token and return false:
@@ -100,10 +208,20 @@ impl GrammarMatcher {
         &mut self,
         token_id: i32,
     ) -> bool {
-        self.inner
+        let accepted = self
+            .inner
             .as_mut()
             .expect("GrammarMatcher inner is null")
-            .AcceptToken(token_id, false)
+            .AcceptToken(token_id, false);
+        if accepted {
+            self.stats.tokens_accepted += 1;
+            if let Some(history) = &mut self.token_history {
+                history.push(token_id);
+            }
+        } else {
+            self.stats.tokens_rejected += 1;
+        }
+        accepted
     }
 
     /// Accept one token with optional debug printing.
@@ -122,10 +240,20 @@ impl GrammarMatcher {
         token_id: i32,
         debug_print: bool,
     ) -> bool {
-        self.inner
+        let accepted = self
+            .inner
             .as_mut()
             .expect("GrammarMatcher inner is null")
-            .AcceptToken(token_id, debug_print)
+            .AcceptToken(token_id, debug_print);
+        if accepted {
+            self.stats.tokens_accepted += 1;
+            if let Some(history) = &mut self.token_history {
+                history.push(token_id);
+            }
+        } else {
+            self.stats.tokens_rejected += 1;
+        }
+        accepted
     }
 
     /// Accept a string and update the state of the matcher. The whole string is considered
@@ -146,23 +274,30 @@ impl GrammarMatcher {
         input: &str,
         debug_print: bool,
     ) -> bool {
-        cxx::let_cxx_string!(input_cxx = input);
-        self.inner
-            .as_mut()
-            .expect("GrammarMatcher inner is null")
-            .AcceptString(&input_cxx, debug_print)
+        self.accept_bytes(input.as_bytes(), debug_print)
     }
 
+    /// Accept a byte slice, like `accept_string` but without requiring valid
+    /// UTF-8. The bytes cross the FFI as a raw span into a reused buffer, so
+    /// re-feeding large cached documents through the matcher allocates
+    /// nothing per call.
     pub fn accept_bytes(
         &mut self,
         input: &[u8],
         debug_print: bool,
     ) -> bool {
-        cxx::let_cxx_string!(input_cxx = input);
-        self.inner
-            .as_mut()
-            .expect("GrammarMatcher inner is null")
-            .AcceptString(&input_cxx, debug_print)
+        let accepted = unsafe {
+            ffi::grammar_matcher_accept_bytes(
+                self.inner.as_mut().expect("GrammarMatcher inner is null"),
+                bytes_as_c_char_ptr(input),
+                input.len(),
+                debug_print,
+            )
+        };
+        if accepted {
+            self.token_history = None;
+        }
+        accepted
     }
 
     /// Fill the bitmask for the next token prediction. The input bitmask must be on CPU.
@@ -191,14 +326,18 @@ impl GrammarMatcher {
         index: i32,
         debug_print: bool,
     ) -> bool {
-        unsafe {
+        let start = Instant::now();
+        let need_apply = unsafe {
             ffi::grammar_matcher_fill_next_token_bitmask(
                 self.inner.as_mut().expect("GrammarMatcher inner is null"),
                 bitmask.as_mut_ptr(),
                 index,
                 debug_print,
             )
-        }
+        };
+        self.stats.fill_bitmask_ns += start.elapsed().as_nanos() as u64;
+        self.stats.fill_bitmask_calls += 1;
+        need_apply
     }
 
     /// Find the jump-forward string for jump-forward decoding. This is the longest string that
@@ -231,6 +370,12 @@ impl GrammarMatcher {
             .as_mut()
             .expect("GrammarMatcher inner is null")
             .Rollback(num_tokens);
+        self.stats.rollback_calls += 1;
+        self.stats.rollback_tokens += num_tokens.max(0) as u64;
+        if let Some(history) = &mut self.token_history {
+            let len = history.len();
+            history.truncate(len.saturating_sub(num_tokens.max(0) as usize));
+        }
     }
 
     /// Check if the matcher has terminated. If `terminate_without_stop_token` is false, the
@@ -256,9 +401,15 @@ impl GrammarMatcher {
     /// Reset the matcher to the initial state.
     pub fn reset(&mut self) {
         self.inner.as_mut().expect("GrammarMatcher inner is null").Reset();
+        match &mut self.token_history {
+            Some(history) => history.clear(),
+            None => self.token_history = Some(Vec::new()),
+        }
     }
 
     /// Fork the matcher, returning a new matcher with an independent copy of the current state.
+    /// The forked matcher starts with zeroed [`MatcherStats`] so its counters attribute only its
+    /// own work.
     pub fn fork(&self) -> Self {
         let inner = ffi::grammar_matcher_fork(
             self.inner.as_ref().expect("GrammarMatcher inner is null"),
@@ -266,9 +417,108 @@ impl GrammarMatcher {
         Self {
             inner,
             stored_stop_token_ids: self.stored_stop_token_ids.clone(),
+            override_stop_tokens: self.override_stop_tokens.clone(),
+            terminate_without_stop_token: self.terminate_without_stop_token,
+            max_rollback_tokens: self.max_rollback_tokens,
+            token_history: self.token_history.clone(),
+            stats: MatcherStats::default(),
+        }
+    }
+
+    /// Fork the matcher into `n` independent branches in one call.
+    ///
+    /// Equivalent to calling `fork` `n` times, but the branch vector is
+    /// allocated once and every copy happens on the C++ side, so branching
+    /// for parallel sampling costs a single FFI crossing. The compiled
+    /// grammar is shared between all branches; only the matcher state is
+    /// copied per branch.
+    ///
+    /// # Parameters
+    ///
+    /// - `n`: The number of branches to create.
+    ///
+    /// # Returns
+    ///
+    /// The forked matchers.
+    pub fn fork_n(
+        &self,
+        n: usize,
+    ) -> Vec<Self> {
+        let mut branches_cxx = ffi::grammar_matcher_fork_n(
+            self.inner.as_ref().expect("GrammarMatcher inner is null"),
+            n,
+        );
+        (0..n)
+            .map(|i| {
+                let inner = ffi::grammar_matcher_vec_take(
+                    branches_cxx
+                        .as_mut()
+                        .expect("forked matcher vector is null"),
+                    i,
+                );
+                assert!(!inner.is_null(), "forked matcher index out of range");
+                Self {
+                    inner,
+                    stored_stop_token_ids: self.stored_stop_token_ids.clone(),
+                    override_stop_tokens: self.override_stop_tokens.clone(),
+                    terminate_without_stop_token: self
+                        .terminate_without_stop_token,
+                    max_rollback_tokens: self.max_rollback_tokens,
+                    token_history: self.token_history.clone(),
+                    stats: MatcherStats::default(),
+                }
+            })
+            .collect()
+    }
+
+    /// Capture the current state as a [`MatcherCheckpoint`].
+    ///
+    /// The checkpoint holds an independent copy of the engine state, so the
+    /// matcher can keep accepting tokens (and restore later) without any
+    /// rollback window. Taking a checkpoint costs one engine-side state
+    /// copy, like [`Self::fork`], but without constructing a whole matcher.
+    pub fn checkpoint(&self) -> MatcherCheckpoint {
+        MatcherCheckpoint {
+            inner: ffi::grammar_matcher_fork(
+                self.inner.as_ref().expect("GrammarMatcher inner is null"),
+            ),
+            token_history: self.token_history.clone(),
         }
     }
 
+    /// Restore the matcher to a checkpoint, keeping the checkpoint valid for
+    /// further restores from the same branch point.
+    ///
+    /// Costs one engine-side state copy regardless of how many tokens were
+    /// accepted since the checkpoint was taken; a deep [`Self::rollback`]
+    /// over the same distance is O(tokens). The checkpoint must have been
+    /// taken from this matcher or one of its forks. [`MatcherStats`]
+    /// counters are not rewound.
+    pub fn restore(
+        &mut self,
+        checkpoint: &MatcherCheckpoint,
+    ) {
+        ffi::grammar_matcher_restore(
+            self.inner.as_mut().expect("GrammarMatcher inner is null"),
+            checkpoint.inner.as_ref().expect("MatcherCheckpoint inner is null"),
+        );
+        self.token_history = checkpoint.token_history.clone();
+    }
+
+    /// Restore the matcher to a checkpoint, consuming it.
+    ///
+    /// This is a constant-time handle swap with no FFI crossing and no state
+    /// copy; use it when abandoning a beam for good. See [`Self::restore`]
+    /// for the reusable variant and the validity requirements.
+    pub fn restore_owned(
+        &mut self,
+        checkpoint: MatcherCheckpoint,
+    ) {
+        assert!(!checkpoint.inner.is_null(), "MatcherCheckpoint inner is null");
+        self.inner = checkpoint.inner;
+        self.token_history = checkpoint.token_history;
+    }
+
     /// Traverse a draft token tree (DFS over the speculative-decoding tree), filling the token
     /// bitmask for each node. Returns `false` on timeout; `time_threshold <= 0` disables it. Does
     /// not change the matcher state.
@@ -333,6 +583,81 @@ impl GrammarMatcher {
         .to_string()
     }
 
+    /// Take a snapshot of the matcher state for transfer to another process
+    /// (see [`MatcherSnapshot`]). `grammar_key` identifies the compiled
+    /// grammar on the receiving side; the grammar itself is referenced, not
+    /// embedded.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the state was changed by `accept_string` or
+    /// `accept_bytes`, which leave no token history to replay.
+    pub fn snapshot(
+        &self,
+        grammar_key: u64,
+    ) -> Result<MatcherSnapshot, String> {
+        let Some(history) = &self.token_history else {
+            return Err("matcher state includes accepted strings or bytes; \
+                 snapshot requires a token-only history"
+                .to_string());
+        };
+        Ok(MatcherSnapshot {
+            grammar_key,
+            override_stop_tokens: self.override_stop_tokens.clone(),
+            terminate_without_stop_token: self.terminate_without_stop_token,
+            max_rollback_tokens: self.max_rollback_tokens,
+            token_ids: history.clone().into_boxed_slice(),
+        })
+    }
+
+    /// Reconstruct a matcher from a snapshot. `compiled_grammar` must be the
+    /// grammar the snapshot's `grammar_key` refers to; the caller resolves
+    /// the key (e.g. through its grammar cache) before restoring. The whole
+    /// token history is replayed engine-side in one FFI crossing.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the matcher cannot be constructed, or if the
+    /// replay rejects a token — which means the snapshot was taken against
+    /// a different grammar than the one supplied.
+    pub fn from_snapshot(
+        compiled_grammar: &CompiledGrammar,
+        snapshot: &MatcherSnapshot,
+    ) -> Result<Self, String> {
+        let mut matcher = Self::new(
+            compiled_grammar,
+            snapshot.override_stop_tokens.as_deref(),
+            snapshot.terminate_without_stop_token,
+            snapshot.max_rollback_tokens,
+        )?;
+        let code = unsafe {
+            ffi::grammar_matcher_replay_tokens_status(
+                matcher.inner.as_mut().expect("GrammarMatcher inner is null"),
+                snapshot.token_ids.as_ptr(),
+                snapshot.token_ids.len(),
+            )
+        };
+        status_to_result(code)?;
+        matcher.token_history = Some(snapshot.token_ids.to_vec());
+        Ok(matcher)
+    }
+
+    /// The cumulative performance counters of this matcher. Reading is a
+    /// plain struct copy; counters keep accumulating until [`Self::reset_stats`].
+    ///
+    /// Only calls made through this wrapper are counted; the batch
+    /// operations on [`super::BatchGrammarMatcher`] update its own
+    /// aggregated stats instead.
+    pub fn stats(&self) -> MatcherStats {
+        self.stats
+    }
+
+    /// Reset the performance counters to zero. Does not touch the matcher
+    /// state.
+    pub fn reset_stats(&mut self) {
+        self.stats = MatcherStats::default();
+    }
+
     pub(crate) fn ffi_mut(&mut self) -> Pin<&mut ffi::GrammarMatcher> {
         self.inner.as_mut().expect("GrammarMatcher inner is null")
     }
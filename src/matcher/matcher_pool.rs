@@ -0,0 +1,105 @@
+use std::collections::HashMap;
+
+use super::GrammarMatcher;
+use crate::compiler::CompiledGrammar;
+
+/// A pool of idle [`GrammarMatcher`]s for servers that cycle through many
+/// short requests.
+///
+/// The engine's matcher keeps its internal stacks and buffers across
+/// [`GrammarMatcher::reset`], but only for the compiled grammar it was
+/// constructed with — there is no rebind operation in the engine's public
+/// API. The pool therefore keeps one free list per grammar key: checking a
+/// matcher in resets it and parks it under its key, and the next checkout
+/// for the same key reuses it instead of constructing a new one. At steady
+/// state a server serving a stable set of grammars performs no
+/// matcher-related allocations.
+///
+/// Keys must identify the compiled grammar stably: two different grammars
+/// must not share a key, or a checkout can return a matcher bound to the
+/// wrong grammar. A content hash of the compilation inputs (as used by the
+/// compiler caches) is a good key; a pointer is not, since addresses are
+/// reused.
+///
+/// The pool is single-threaded like the rest of the wrapper types; wrap it
+/// in a lock to share it between server threads.
+pub struct MatcherPool {
+    terminate_without_stop_token: bool,
+    max_rollback_tokens: i32,
+    max_idle_per_grammar: usize,
+    idle: HashMap<u64, Vec<GrammarMatcher>>,
+}
+
+impl MatcherPool {
+    /// Create an empty pool. All matchers it constructs use the given
+    /// `terminate_without_stop_token` and `max_rollback_tokens` settings
+    /// (see [`GrammarMatcher::new`]). At most `max_idle_per_grammar` idle
+    /// matchers are kept per grammar key; matchers checked in beyond that
+    /// are dropped.
+    pub fn new(
+        terminate_without_stop_token: bool,
+        max_rollback_tokens: i32,
+        max_idle_per_grammar: usize,
+    ) -> Self {
+        Self {
+            terminate_without_stop_token,
+            max_rollback_tokens,
+            max_idle_per_grammar,
+            idle: HashMap::new(),
+        }
+    }
+
+    /// Take a matcher for `compiled_grammar` out of the pool, reusing an
+    /// idle one under `key` if available and constructing a new one
+    /// otherwise. The returned matcher is always in the initial state.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if a new grammar matcher cannot be constructed.
+    pub fn checkout(
+        &mut self,
+        key: u64,
+        compiled_grammar: &CompiledGrammar,
+    ) -> Result<GrammarMatcher, String> {
+        if let Some(matcher) = self.idle.get_mut(&key).and_then(Vec::pop) {
+            return Ok(matcher);
+        }
+        GrammarMatcher::new(
+            compiled_grammar,
+            None,
+            self.terminate_without_stop_token,
+            self.max_rollback_tokens,
+        )
+    }
+
+    /// Return a matcher to the pool under `key`. The matcher is reset (state
+    /// and stats) before it is parked; if the free list for `key` is already
+    /// at `max_idle_per_grammar`, the matcher is dropped instead.
+    pub fn checkin(
+        &mut self,
+        key: u64,
+        mut matcher: GrammarMatcher,
+    ) {
+        let free = self.idle.entry(key).or_default();
+        if free.len() >= self.max_idle_per_grammar {
+            return;
+        }
+        matcher.reset();
+        matcher.reset_stats();
+        free.push(matcher);
+    }
+
+    /// The number of idle matchers parked under `key`.
+    pub fn idle_count(
+        &self,
+        key: u64,
+    ) -> usize {
+        self.idle.get(&key).map_or(0, Vec::len)
+    }
+
+    /// Drop all idle matchers, releasing their memory. Checked-out matchers
+    /// are unaffected.
+    pub fn clear(&mut self) {
+        self.idle.clear();
+    }
+}
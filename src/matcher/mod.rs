@@ -4,10 +4,26 @@
 use crate::{CxxUniquePtr, DLTensor};
 
 mod batch_grammar_matcher;
+mod batch_matcher_pipeline;
+mod bitmask_ops;
+mod checkpoint;
 mod grammar_matcher;
+mod matcher_pool;
+mod snapshot;
+mod stats;
 
-pub use batch_grammar_matcher::BatchGrammarMatcher;
+pub use batch_grammar_matcher::{BatchGrammarMatcher, JumpForwardStrings};
+pub use batch_matcher_pipeline::{BatchMatcherPipeline, PipelineStep};
+pub use bitmask_ops::{
+    bitmask_and_inplace, bitmask_andnot_inplace, bitmask_count_allowed,
+    bitmask_first_allowed, bitmask_iter_allowed, bitmask_next_allowed,
+    bitmask_or_inplace,
+};
+pub use checkpoint::MatcherCheckpoint;
 pub use grammar_matcher::GrammarMatcher;
+pub use matcher_pool::MatcherPool;
+pub use snapshot::MatcherSnapshot;
+pub use stats::MatcherStats;
 
 /// Return the shape of the bitmask: (batch_size, ceil(vocab_size / 32)).
 pub fn get_bitmask_shape(
@@ -51,6 +67,35 @@ pub fn reset_token_bitmask(bitmask: &mut [i32]) {
     bitmask.fill(-1i32);
 }
 
+/// Apply the bitmask to the logits in place, dispatching on the device of
+/// the logits tensor. CPU (and CUDA-host-pinned) logits take the same path
+/// as `apply_token_bitmask_inplace_cpu`; other devices return an error until
+/// device kernels are built into the crate. Use this entry point instead of
+/// the `_cpu` one when the logits device is not known statically.
+pub fn apply_token_bitmask_inplace(
+    logits: &mut CxxUniquePtr<DLTensor>,
+    bitmask: &DLTensor,
+    vocab_size: Option<i32>,
+    indices: Option<&[i32]>,
+) -> Result<(), String> {
+    let vocab_size_i32 = vocab_size.unwrap_or(-1);
+    let (has_indices, indices_ptr, indices_len) = match indices {
+        Some(slice) if !slice.is_empty() => (true, slice.as_ptr(), slice.len()),
+        _ => (false, std::ptr::null(), 0usize),
+    };
+    let code = unsafe {
+        crate::ffi::apply_token_bitmask_inplace_status(
+            logits.as_mut_ptr(),
+            bitmask as *const _,
+            vocab_size_i32,
+            has_indices,
+            indices_ptr,
+            indices_len,
+        )
+    };
+    crate::utils::status_to_result(code)
+}
+
 pub fn apply_token_bitmask_inplace_cpu(
     logits: &mut CxxUniquePtr<DLTensor>,
     bitmask: &DLTensor,
@@ -62,20 +107,15 @@ pub fn apply_token_bitmask_inplace_cpu(
         Some(slice) if !slice.is_empty() => (true, slice.as_ptr(), slice.len()),
         _ => (false, std::ptr::null(), 0usize),
     };
-    cxx::let_cxx_string!(error_out_cxx = "");
-    let ok = unsafe {
-        crate::ffi::apply_token_bitmask_inplace_cpu(
+    let code = unsafe {
+        crate::ffi::apply_token_bitmask_inplace_cpu_status(
             logits.as_mut_ptr(),
             bitmask as *const _,
             vocab_size_i32,
             has_indices,
             indices_ptr,
             indices_len,
-            error_out_cxx.as_mut().get_unchecked_mut(),
         )
     };
-    if !ok {
-        return Err(error_out_cxx.to_string());
-    }
-    Ok(())
+    crate::utils::status_to_result(code)
 }
@@ -0,0 +1,148 @@
+use crate::{DeserializeError, binary_format};
+
+/// A compact, portable snapshot of a live [`super::GrammarMatcher`]'s state.
+///
+/// The engine exposes no way to serialize the pushdown state directly, so a
+/// snapshot records what produced it: the matcher's construction options and
+/// its accepted-token history. Restoring constructs a fresh matcher and
+/// replays the whole history engine-side in a single FFI crossing, which is
+/// far cheaper than re-accepting tokens one call at a time. The compiled
+/// grammar is referenced by a caller-chosen `grammar_key` (e.g. the content
+/// hash the compiler caches use), not embedded, so replicas sharing a
+/// grammar cache transfer only a few bytes per token of session depth.
+///
+/// Snapshots are available while the matcher's state was built exclusively
+/// from `accept_token` calls (plus `rollback` and `reset`); accepting raw
+/// strings or bytes leaves no token history to replay and disables
+/// snapshotting until the next `reset`.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct MatcherSnapshot {
+    pub(crate) grammar_key: u64,
+    pub(crate) override_stop_tokens: Option<Box<[i32]>>,
+    pub(crate) terminate_without_stop_token: bool,
+    pub(crate) max_rollback_tokens: i32,
+    pub(crate) token_ids: Box<[i32]>,
+}
+
+impl MatcherSnapshot {
+    /// The caller-chosen key identifying the compiled grammar this snapshot
+    /// was taken against.
+    pub fn grammar_key(&self) -> u64 {
+        self.grammar_key
+    }
+
+    /// The accepted-token history the snapshot replays on restore.
+    pub fn token_ids(&self) -> &[i32] {
+        &self.token_ids
+    }
+
+    /// Serialize the snapshot into a versioned binary container (the same
+    /// container format `CompiledGrammar::serialize_bytes` uses).
+    pub fn to_bytes(&self) -> Vec<u8> {
+        let override_len =
+            self.override_stop_tokens.as_ref().map_or(0, |tokens| tokens.len());
+        let mut payload = Vec::with_capacity(
+            8 + 1 + 4 + 4 + 4 * override_len + 4 + 4 * self.token_ids.len(),
+        );
+        payload.extend_from_slice(&self.grammar_key.to_le_bytes());
+        let flags = u8::from(self.terminate_without_stop_token)
+            | (u8::from(self.override_stop_tokens.is_some()) << 1);
+        payload.push(flags);
+        payload.extend_from_slice(&self.max_rollback_tokens.to_le_bytes());
+        if let Some(tokens) = &self.override_stop_tokens {
+            payload.extend_from_slice(&(tokens.len() as u32).to_le_bytes());
+            for token in tokens.iter() {
+                payload.extend_from_slice(&token.to_le_bytes());
+            }
+        }
+        payload.extend_from_slice(&(self.token_ids.len() as u32).to_le_bytes());
+        for token in self.token_ids.iter() {
+            payload.extend_from_slice(&token.to_le_bytes());
+        }
+        binary_format::encode(
+            binary_format::PayloadKind::MatcherSnapshot,
+            &payload,
+        )
+    }
+
+    /// Deserialize a snapshot from a container produced by `to_bytes`.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the container header is malformed, holds a
+    /// different payload kind, was produced by an incompatible serialization
+    /// version, or the payload is truncated.
+    pub fn from_bytes(bytes: &[u8]) -> Result<Self, DeserializeError> {
+        let payload = binary_format::decode(
+            binary_format::PayloadKind::MatcherSnapshot,
+            bytes,
+        )?;
+
+        fn take<'a>(
+            rest: &mut &'a [u8],
+            n: usize,
+            what: &str,
+        ) -> Result<&'a [u8], DeserializeError> {
+            if rest.len() < n {
+                return Err(DeserializeError::Format(format!(
+                    "truncated matcher snapshot: missing {what}"
+                )));
+            }
+            let (head, tail) = rest.split_at(n);
+            *rest = tail;
+            Ok(head)
+        }
+
+        fn take_i32_slice(
+            rest: &mut &[u8],
+            what: &str,
+        ) -> Result<Box<[i32]>, DeserializeError> {
+            let len =
+                u32::from_le_bytes(take(rest, 4, what)?.try_into().unwrap())
+                    as usize;
+            // The length prefix is untrusted; check it against the bytes
+            // actually present before allocating, so a corrupted container
+            // yields `Err` instead of a huge allocation.
+            if len > rest.len() / 4 {
+                return Err(DeserializeError::Format(format!(
+                    "truncated matcher snapshot: missing {what}"
+                )));
+            }
+            let mut values = Vec::with_capacity(len);
+            for _ in 0..len {
+                values.push(i32::from_le_bytes(
+                    take(rest, 4, what)?.try_into().unwrap(),
+                ));
+            }
+            Ok(values.into_boxed_slice())
+        }
+
+        let rest = &mut &payload[..];
+        let grammar_key = u64::from_le_bytes(
+            take(rest, 8, "grammar key")?.try_into().unwrap(),
+        );
+        let flags = take(rest, 1, "flags")?[0];
+        let max_rollback_tokens = i32::from_le_bytes(
+            take(rest, 4, "max rollback tokens")?.try_into().unwrap(),
+        );
+        let override_stop_tokens = if flags & 0b10 != 0 {
+            Some(take_i32_slice(rest, "override stop tokens")?)
+        } else {
+            None
+        };
+        let token_ids = take_i32_slice(rest, "token history")?;
+        if !rest.is_empty() {
+            return Err(DeserializeError::Format(format!(
+                "matcher snapshot has {} trailing bytes",
+                rest.len()
+            )));
+        }
+        Ok(Self {
+            grammar_key,
+            override_stop_tokens,
+            terminate_without_stop_token: flags & 0b01 != 0,
+            max_rollback_tokens,
+            token_ids,
+        })
+    }
+}
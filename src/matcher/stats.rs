@@ -0,0 +1,47 @@
+/// Lightweight cumulative performance counters for a matcher.
+///
+/// The counters are updated by the wrapper around each hot call and read
+/// with a plain struct copy, so reading them costs nothing and never
+/// allocates — cheap enough to scrape into a metrics system on every decode
+/// step. Counters internal to the engine (adaptive-mask cache hits, parser
+/// stack depth) are not part of its public API and are not included.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct MatcherStats {
+    /// Cumulative wall time spent filling next-token bitmasks, in
+    /// nanoseconds. For `BatchGrammarMatcher` this covers the whole batch
+    /// fill.
+    pub fill_bitmask_ns: u64,
+    /// Number of bitmask-fill calls.
+    pub fill_bitmask_calls: u64,
+    /// Number of tokens accepted by `accept_token`.
+    pub tokens_accepted: u64,
+    /// Number of tokens rejected by `accept_token`.
+    pub tokens_rejected: u64,
+    /// Number of `rollback` calls.
+    pub rollback_calls: u64,
+    /// Total number of tokens rolled back.
+    pub rollback_tokens: u64,
+}
+
+impl MatcherStats {
+    /// Add the counters of `other` into `self`. Used to aggregate the stats
+    /// of the matchers of one batch:
+    ///
+    /// ```ignore
+    /// let mut total = MatcherStats::default();
+    /// for matcher in &matchers {
+    ///     total.merge(&matcher.stats());
+    /// }
+    /// ```
+    pub fn merge(
+        &mut self,
+        other: &MatcherStats,
+    ) {
+        self.fill_bitmask_ns += other.fill_bitmask_ns;
+        self.fill_bitmask_calls += other.fill_bitmask_calls;
+        self.tokens_accepted += other.tokens_accepted;
+        self.tokens_rejected += other.tokens_rejected;
+        self.rollback_calls += other.rollback_calls;
+        self.rollback_tokens += other.rollback_tokens;
+    }
+}
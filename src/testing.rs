@@ -254,3 +254,28 @@ pub fn print_grammar_fsms(grammar: &Grammar) -> Result<String, String> {
     }
     Ok(result.to_string())
 }
+
+/// A no-op FFI crossing, for the benchmark suite. Measures the fixed cost of
+/// calling through the bridge with no arguments and no work on the C++ side.
+pub fn bench_ffi_noop() {
+    ffi::bench_ffi_noop();
+}
+
+/// A no-op FFI crossing using the raw-pointer + `error_out` convention of
+/// the matcher entry points, for the benchmark suite. Measures the fixed
+/// per-call glue cost (string setup, pointer marshalling, error check)
+/// without any engine work.
+pub fn bench_ffi_noop_status(values: &[i32]) -> Result<(), String> {
+    cxx::let_cxx_string!(error_out_cxx = "");
+    let ok = unsafe {
+        ffi::bench_ffi_noop_status(
+            values.as_ptr(),
+            values.len(),
+            error_out_cxx.as_mut().get_unchecked_mut(),
+        )
+    };
+    if !ok {
+        return Err(error_out_cxx.to_string());
+    }
+    Ok(())
+}
@@ -1,10 +1,32 @@
 use crate::{
-    CxxUniquePtr, DeserializeError, ffi,
+    CxxUniquePtr, DeserializeError, binary_format,
+    compiler::ContentHasher,
+    ffi,
     utils::{bytes_as_c_char_ptr, tie_enum_with_ffi},
 };
 
 type StopTokenIds = Option<Box<[i32]>>;
 
+/// Packs a vocabulary into one contiguous byte buffer plus an offsets table
+/// (`offsets.len() == num_tokens + 1`), so the whole vocab crosses the FFI
+/// boundary in a single call instead of one call per token.
+fn pack_vocab<I, B>(encoded_vocab: I) -> (Vec<u8>, Vec<usize>)
+where
+    I: IntoIterator<Item = B>,
+    B: AsRef<[u8]>,
+{
+    let iter = encoded_vocab.into_iter();
+    let (lower, _) = iter.size_hint();
+    let mut buffer: Vec<u8> = Vec::new();
+    let mut offsets: Vec<usize> = Vec::with_capacity(lower + 1);
+    offsets.push(0);
+    for token in iter {
+        buffer.extend_from_slice(token.as_ref());
+        offsets.push(buffer.len());
+    }
+    (buffer, offsets)
+}
+
 // Rust enum that corresponds to `ffi::VocabType`
 #[derive(PartialEq, Eq, Clone, Debug, Hash)]
 #[repr(i32)]
@@ -129,21 +151,8 @@ impl TokenizerInfo {
         stop_token_ids: &StopTokenIds,
         add_prefix_space: bool,
     ) -> Result<Self, String> {
-        let mut cxx_vec = ffi::new_string_vector();
-        {
-            let mut cxx_vec_pin = cxx_vec.pin_mut();
-            ffi::string_vec_reserve(cxx_vec_pin.as_mut(), encoded_vocab.len());
-            for string in encoded_vocab.iter() {
-                let bytes = string.as_ref().as_bytes();
-                unsafe {
-                    ffi::string_vec_push_bytes(
-                        cxx_vec_pin.as_mut(),
-                        bytes_as_c_char_ptr(bytes),
-                        bytes.len(),
-                    );
-                }
-            }
-        }
+        let (buffer, offsets) =
+            pack_vocab(encoded_vocab.iter().map(|s| s.as_ref().as_bytes()));
         let (has_vocab_size, vocab_size_i32) = match vocab_size {
             Some(sz) => (true, sz as i32),
             None => (false, 0i32),
@@ -158,8 +167,11 @@ impl TokenizerInfo {
 
         cxx::let_cxx_string!(error_out_cxx = "");
         let ffi_obj = unsafe {
-            ffi::make_tokenizer_info(
-                cxx_vec.as_ref().unwrap(),
+            ffi::make_tokenizer_info_from_packed(
+                bytes_as_c_char_ptr(&buffer),
+                buffer.len(),
+                offsets.as_ptr(),
+                offsets.len(),
                 vocab_type.into(),
                 has_vocab_size,
                 vocab_size_i32,
@@ -194,26 +206,18 @@ impl TokenizerInfo {
         I: IntoIterator<Item = B>,
         B: AsRef<[u8]>,
     {
-        let mut cxx_vec = ffi::new_string_vector();
-        {
-            let mut cxx_vec_pin = cxx_vec.pin_mut();
-            for string in encoded_vocab.into_iter() {
-                let bytes = string.as_ref();
-                unsafe {
-                    ffi::string_vec_push_bytes(
-                        cxx_vec_pin.as_mut(),
-                        bytes_as_c_char_ptr(bytes),
-                        bytes.len(),
-                    );
-                }
-            }
-        }
+        let (buffer, offsets) = pack_vocab(encoded_vocab);
 
         cxx::let_cxx_string!(metadata_cxx = metadata);
-        let ffi_ptr = ffi::tokenizer_info_from_vocab_and_metadata(
-            cxx_vec.as_ref().unwrap(),
-            &metadata_cxx,
-        );
+        let ffi_ptr = unsafe {
+            ffi::tokenizer_info_from_packed_vocab_and_metadata(
+                bytes_as_c_char_ptr(&buffer),
+                buffer.len(),
+                offsets.as_ptr(),
+                offsets.len(),
+                &metadata_cxx,
+            )
+        };
         Self {
             inner: ffi_ptr,
         }
@@ -324,6 +328,146 @@ impl TokenizerInfo {
         })
     }
 
+    /// Serialize the tokenizer info to a versioned binary container.
+    ///
+    /// The container header carries the serialization version, so an
+    /// incompatible file is rejected from its first few bytes without
+    /// parsing the payload.
+    ///
+    /// # Returns
+    ///
+    /// The binary container bytes.
+    pub fn serialize_bytes(&self) -> Vec<u8> {
+        binary_format::encode(
+            binary_format::PayloadKind::TokenizerInfo,
+            self.serialize_json().as_bytes(),
+        )
+    }
+
+    /// Deserialize a tokenizer info from a binary container produced by
+    /// `serialize_bytes`.
+    ///
+    /// # Parameters
+    ///
+    /// - `bytes`: The binary container bytes.
+    ///
+    /// # Returns
+    ///
+    /// The tokenizer info.
+    ///
+    /// # Errors
+    ///
+    /// - When the container header is malformed or holds a different payload
+    ///   kind.
+    /// - When the container was produced by an incompatible serialization
+    ///   version.
+    /// - When the payload fails to deserialize.
+    pub fn deserialize_bytes(bytes: &[u8]) -> Result<Self, DeserializeError> {
+        let json = binary_format::decode_json_payload(
+            binary_format::PayloadKind::TokenizerInfo,
+            bytes,
+        )?;
+        Self::deserialize_json(json)
+    }
+
+    /// Registry-aware variant of [`Self::new_with_vocab_size`]: identical
+    /// construction inputs return handles sharing one process-wide
+    /// `TokenizerInfo`, so e.g. several LoRA variants of the same base model
+    /// pay for the decoded vocabulary tables once. The registry holds its
+    /// entries for the lifetime of the process; see
+    /// [`Self::registry_clear`].
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the tokenizer info cannot be constructed.
+    pub fn new_shared<T: AsRef<str>>(
+        encoded_vocab: &[T],
+        vocab_type: VocabType,
+        vocab_size: Option<usize>,
+        stop_token_ids: &StopTokenIds,
+        add_prefix_space: bool,
+    ) -> Result<Self, String> {
+        let mut hasher = ContentHasher::new();
+        hasher.write(b"tokenizer_vocab");
+        for token in encoded_vocab {
+            hasher.write(token.as_ref().as_bytes());
+        }
+        hasher.write(&(vocab_type.clone() as i32).to_le_bytes());
+        hasher.write(&(vocab_size.map_or(-1i64, |sz| sz as i64)).to_le_bytes());
+        if let Some(ids) = stop_token_ids.as_ref() {
+            for id in ids.iter() {
+                hasher.write(&id.to_le_bytes());
+            }
+        }
+        hasher.write(&[u8::from(add_prefix_space)]);
+        let key = hasher.finish();
+
+        let hit = ffi::tokenizer_registry_lookup(key);
+        if !hit.is_null() {
+            return Ok(Self::from_unique_ptr(hit));
+        }
+        let info = Self::new_with_vocab_size(
+            encoded_vocab,
+            vocab_type,
+            vocab_size,
+            stop_token_ids,
+            add_prefix_space,
+        )?;
+        ffi::tokenizer_registry_insert(key, info.ffi_ref());
+        Ok(info)
+    }
+
+    /// Registry-aware variant of [`Self::deserialize_json`]: deserializing
+    /// the same JSON twice returns handles sharing one process-wide
+    /// `TokenizerInfo` instead of two independent copies.
+    ///
+    /// # Errors
+    ///
+    /// Same as [`Self::deserialize_json`].
+    pub fn deserialize_json_shared(
+        json: &str
+    ) -> Result<Self, DeserializeError> {
+        let key = ContentHasher::new()
+            .write(b"tokenizer_json")
+            .write(json.as_bytes())
+            .finish();
+        let hit = ffi::tokenizer_registry_lookup(key);
+        if !hit.is_null() {
+            return Ok(Self::from_unique_ptr(hit));
+        }
+        let info = Self::deserialize_json(json)?;
+        ffi::tokenizer_registry_insert(key, info.ffi_ref());
+        Ok(info)
+    }
+
+    /// Registry-aware variant of [`Self::deserialize_bytes`].
+    ///
+    /// # Errors
+    ///
+    /// Same as [`Self::deserialize_bytes`].
+    pub fn deserialize_bytes_shared(
+        bytes: &[u8]
+    ) -> Result<Self, DeserializeError> {
+        let json = binary_format::decode_json_payload(
+            binary_format::PayloadKind::TokenizerInfo,
+            bytes,
+        )?;
+        Self::deserialize_json_shared(json)
+    }
+
+    /// The number of distinct tokenizers currently held by the process-wide
+    /// registry.
+    pub fn registry_size() -> usize {
+        ffi::tokenizer_registry_size()
+    }
+
+    /// Drop all registry entries. Handles already handed out stay valid (the
+    /// underlying data is shared); only the registry's own references are
+    /// released, so unused tokenizers can be freed.
+    pub fn registry_clear() {
+        ffi::tokenizer_registry_clear();
+    }
+
     pub(crate) fn ffi_ref(&self) -> &ffi::TokenizerInfo {
         self.inner.as_ref().expect("UniquePtr was null")
     }
@@ -337,6 +481,15 @@ impl TokenizerInfo {
     }
 }
 
+impl Clone for TokenizerInfo {
+    /// Cheap handle copy; the underlying tokenizer data is shared.
+    fn clone(&self) -> Self {
+        Self {
+            inner: ffi::tokenizer_info_clone(self.ffi_ref()),
+        }
+    }
+}
+
 impl Drop for TokenizerInfo {
     fn drop(&mut self) {}
 }
@@ -64,3 +64,17 @@ macro_rules! tie_enum_with_ffi {
     };
 }
 pub(crate) use tie_enum_with_ffi;
+
+/// Convert a status code from the exception-free glue ABI (`status.hpp`)
+/// into a `Result`, fetching the thread-local failure detail only when the
+/// call actually failed — the success path moves no strings at all.
+pub(crate) fn status_to_result(code: i32) -> Result<(), String> {
+    if code == 0 {
+        return Ok(());
+    }
+    cxx::let_cxx_string!(detail_cxx = "");
+    unsafe {
+        crate::ffi::copy_status_detail(detail_cxx.as_mut().get_unchecked_mut());
+    }
+    Err(detail_cxx.to_string())
+}
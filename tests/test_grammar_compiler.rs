@@ -380,3 +380,263 @@ fn test_grammar_compiler_cache_limited() {
     grammar_compiler.clear_cache();
     assert_eq!(grammar_compiler.get_cache_size_bytes(), 0);
 }
+
+#[test]
+#[serial]
+fn test_grammar_compiler_persistent_cache() {
+    let vocab =
+        ["a", "b", "c", "{", "}", "\"", ":", ",", " ", "true", "false", "null"];
+    let cache_dir = std::env::temp_dir().join(format!(
+        "xgrammar_rs_persistent_cache_test_{}",
+        std::process::id()
+    ));
+    let _ = std::fs::remove_dir_all(&cache_dir);
+    let schema = "{\"properties\":{\"name\":{\"type\":\"string\"}},\"required\":[\"name\"],\"type\":\"object\"}";
+
+    // First compiler populates the disk cache.
+    {
+        let tokenizer_info =
+            TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+        let mut compiler =
+            GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+        compiler.set_persistent_cache_dir(&cache_dir).unwrap();
+        assert_eq!(compiler.persistent_cache_dir(), Some(cache_dir.as_path()));
+        let compiled = compiler
+            .compile_json_schema(
+                schema,
+                true,
+                None,
+                None::<(&str, &str)>,
+                true,
+                None,
+            )
+            .unwrap();
+        assert!(compiled.memory_size_bytes() > 0);
+    }
+    let entries: Vec<_> = std::fs::read_dir(&cache_dir)
+        .unwrap()
+        .map(|e| e.unwrap().path())
+        .collect();
+    assert_eq!(entries.len(), 1, "one cache entry expected: {entries:?}");
+
+    // A fresh compiler (cold in-memory cache) must load the entry from disk
+    // and produce a working compiled grammar.
+    {
+        let tokenizer_info =
+            TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+        let mut compiler =
+            GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+        compiler.set_persistent_cache_dir(&cache_dir).unwrap();
+        let compiled = compiler
+            .compile_json_schema(
+                schema,
+                true,
+                None,
+                None::<(&str, &str)>,
+                true,
+                None,
+            )
+            .unwrap();
+        let mut matcher =
+            xgrammar::GrammarMatcher::new(&compiled, None, true, -1).unwrap();
+        assert!(matcher.accept_string("{\"name\":\"a\"}", false));
+        assert!(matcher.is_terminated());
+    }
+
+    let _ = std::fs::remove_dir_all(&cache_dir);
+}
+
+#[test]
+#[serial]
+fn test_grammar_compiler_compile_async() {
+    let vocab =
+        ["a", "b", "c", "{", "}", "\"", ":", ",", " ", "true", "false", "null"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 2, true, -1).unwrap();
+
+    let schema = "{\"properties\":{\"name\":{\"type\":\"string\"}},\"required\":[\"name\"],\"type\":\"object\"}";
+    let future = compiler
+        .compile_json_schema_async(
+            schema,
+            true,
+            None,
+            None::<(&str, &str)>,
+            true,
+            None,
+        )
+        .unwrap();
+    // Polling must not consume the result.
+    let _ = future.is_ready();
+    let compiled = future.wait().unwrap();
+    let mut matcher =
+        xgrammar::GrammarMatcher::new(&compiled, None, true, -1).unwrap();
+    assert!(matcher.accept_string("{\"name\":\"a\"}", false));
+    assert!(matcher.is_terminated());
+
+    // A failing compilation reports its error at wait time.
+    let bad = compiler.compile_regex_async("(unclosed").unwrap();
+    assert!(bad.wait().is_err());
+
+    // The builtin-JSON path works through the async API as well.
+    let builtin = compiler.compile_builtin_json_grammar_async().unwrap();
+    assert!(builtin.wait().unwrap().memory_size_bytes() > 0);
+}
+
+#[test]
+#[serial]
+fn test_grammar_compiler_compile_json_schema_batch() {
+    let vocab =
+        ["a", "b", "c", "{", "}", "\"", ":", ",", " ", "true", "false", "null"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 2, true, -1).unwrap();
+
+    let schemas = [
+        "{\"properties\":{\"a\":{\"type\":\"string\"}},\"type\":\"object\"}"
+            .to_string(),
+        "not a schema".to_string(),
+        "{\"properties\":{\"b\":{\"type\":\"boolean\"}},\"type\":\"object\"}"
+            .to_string(),
+    ];
+    let results = compiler
+        .compile_json_schema_batch(
+            &schemas,
+            true,
+            None,
+            None::<(&str, &str)>,
+            true,
+            None,
+            Some(2),
+        )
+        .unwrap();
+    assert_eq!(results.len(), 3);
+    assert!(results[0].is_ok());
+    assert!(results[1].is_err());
+    assert!(results[2].is_ok());
+
+    let compiled = results[0].as_ref().unwrap();
+    let mut matcher =
+        xgrammar::GrammarMatcher::new(compiled, None, true, -1).unwrap();
+    assert!(matcher.accept_string("{\"a\":\"c\"}", false));
+    assert!(matcher.is_terminated());
+}
+
+#[test]
+#[serial]
+fn test_grammar_compiler_coalesced_compiles() {
+    let vocab =
+        ["a", "b", "c", "{", "}", "\"", ":", ",", " ", "true", "false", "null"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 2, true, -1).unwrap();
+    assert_eq!(compiler.coalesced_compile_waits(), 0);
+
+    let schema =
+        "{\"properties\":{\"a\":{\"type\":\"string\"}},\"type\":\"object\"}";
+
+    // Launch several async compilations of the same uncached schema; the
+    // first one compiles, the rest join it in flight.
+    let futures: Vec<_> = (0..4)
+        .map(|_| {
+            compiler
+                .compile_json_schema_async(
+                    schema,
+                    true,
+                    None,
+                    None::<(&str, &str)>,
+                    true,
+                    None,
+                )
+                .unwrap()
+        })
+        .collect();
+    for future in futures {
+        let compiled = future.wait().unwrap();
+        assert!(compiled.memory_size_bytes() > 0);
+    }
+
+    // The sync path goes through the same coalescer; with nothing in
+    // flight anymore it compiles (or hits the engine cache) on its own.
+    let waits_after_async = compiler.coalesced_compile_waits();
+    let compiled = compiler
+        .compile_json_schema(
+            schema,
+            true,
+            None,
+            None::<(&str, &str)>,
+            true,
+            None,
+        )
+        .unwrap();
+    assert!(compiled.memory_size_bytes() > 0);
+    assert_eq!(compiler.coalesced_compile_waits(), waits_after_async);
+}
+
+#[test]
+#[serial]
+fn test_live_compiled_grammar_accounting() {
+    use xgrammar::{live_compiled_grammar_bytes, live_compiled_grammar_count};
+
+    let vocab = ["a", "b", "c"];
+    let tok = TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler = GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+
+    // Other tests may hold live grammars; assert on deltas only.
+    let bytes_before = live_compiled_grammar_bytes();
+    let count_before = live_compiled_grammar_count();
+
+    let grammar = xgrammar::Grammar::from_regex("a+", false).unwrap();
+    let compiled = compiler.compile_grammar(&grammar).unwrap();
+    let size = compiled.memory_size_bytes();
+    assert!(size > 0);
+    assert_eq!(live_compiled_grammar_count(), count_before + 1);
+    assert_eq!(live_compiled_grammar_bytes(), bytes_before + size);
+
+    {
+        let json = compiled.serialize_json();
+        let other =
+            xgrammar::CompiledGrammar::deserialize_json(&json, &tok).unwrap();
+        assert_eq!(live_compiled_grammar_count(), count_before + 2);
+        assert_eq!(
+            live_compiled_grammar_bytes(),
+            bytes_before + size + other.memory_size_bytes()
+        );
+    }
+    assert_eq!(live_compiled_grammar_count(), count_before + 1);
+    assert_eq!(live_compiled_grammar_bytes(), bytes_before + size);
+
+    drop(compiled);
+    assert_eq!(live_compiled_grammar_count(), count_before);
+    assert_eq!(live_compiled_grammar_bytes(), bytes_before);
+}
+
+#[test]
+#[serial]
+fn test_grammar_bundle_evict() {
+    use xgrammar::{GrammarBundle, GrammarBundleBuilder};
+
+    let vocab = ["a", "b"];
+    let tok = TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler = GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+    let grammar = xgrammar::Grammar::from_regex("a+", false).unwrap();
+    let compiled = compiler.compile_grammar(&grammar).unwrap();
+
+    let mut builder = GrammarBundleBuilder::new();
+    builder.add(7, &compiled);
+    let mut bundle = GrammarBundle::from_bytes(builder.to_bytes()).unwrap();
+
+    assert!(bundle.get(7, &tok).unwrap().is_some());
+    assert_eq!(bundle.materialized_count(), 1);
+
+    assert!(bundle.evict(7));
+    assert_eq!(bundle.materialized_count(), 0);
+    assert!(!bundle.evict(7));
+
+    // Entry is still in the archive and can be materialized again.
+    assert!(bundle.get(7, &tok).unwrap().is_some());
+    assert_eq!(bundle.materialized_count(), 1);
+}
@@ -673,7 +673,8 @@ fn test_batch_accept_string() {
             grammar_objs.iter().map(matcher_from_grammar).collect();
 
         let results =
-            BatchGrammarMatcher::batch_accept_string(&matchers, &inputs, false);
+            BatchGrammarMatcher::batch_accept_string(&matchers, &inputs, false)
+                .unwrap();
         assert_eq!(&*results, expecteds.as_slice());
     }
 }
@@ -719,7 +720,8 @@ fn test_batch_accept_token() {
             .collect();
 
         let results =
-            BatchGrammarMatcher::batch_accept_token(&matchers, &inputs, false);
+            BatchGrammarMatcher::batch_accept_token(&matchers, &inputs, false)
+                .unwrap();
         assert_eq!(&*results, expecteds.as_slice());
     }
 }
@@ -769,12 +771,9 @@ fn test_batch_fill_next_token_bitmask() {
     ];
 
     let mut batch_grammar_matcher = BatchGrammarMatcher::new(2).unwrap();
-    batch_grammar_matcher.batch_fill_next_token_bitmask(
-        &matchers,
-        &mut tensor,
-        None,
-        false,
-    );
+    batch_grammar_matcher
+        .batch_fill_next_token_bitmask(&matchers, &mut tensor, None, false)
+        .unwrap();
 
     for i in 0..batch_size {
         let rejected_token_ids = get_masked_tokens_from_bitmask(
@@ -792,16 +791,14 @@ fn test_batch_fill_next_token_bitmask() {
     assert_eq!(
         &*BatchGrammarMatcher::batch_accept_string(
             &matchers, &input_str, false
-        ),
+        )
+        .unwrap(),
         &[true, true, true, true]
     );
 
-    batch_grammar_matcher.batch_fill_next_token_bitmask(
-        &matchers,
-        &mut tensor,
-        None,
-        false,
-    );
+    batch_grammar_matcher
+        .batch_fill_next_token_bitmask(&matchers, &mut tensor, None, false)
+        .unwrap();
 
     for i in 0..batch_size {
         let rejected_token_ids = get_masked_tokens_from_bitmask(
@@ -852,12 +849,9 @@ fn test_batch_fill_next_token_bitmask_pressure() {
     ];
 
     let mut batch_matcher = BatchGrammarMatcher::new(2).unwrap();
-    batch_matcher.batch_fill_next_token_bitmask(
-        &matchers,
-        &mut tensor,
-        None,
-        false,
-    );
+    batch_matcher
+        .batch_fill_next_token_bitmask(&matchers, &mut tensor, None, false)
+        .unwrap();
 
     for i in 0..matchers.len() {
         let slice_len = bitmask_data.len() / batch_size;
@@ -911,12 +905,9 @@ fn test_batch_fill_next_token_bitmask_pressure_single_thread() {
     ];
 
     let mut batch_matcher = BatchGrammarMatcher::new(1).unwrap();
-    batch_matcher.batch_fill_next_token_bitmask(
-        &matchers,
-        &mut tensor,
-        None,
-        false,
-    );
+    batch_matcher
+        .batch_fill_next_token_bitmask(&matchers, &mut tensor, None, false)
+        .unwrap();
 
     for i in 0..matchers.len() {
         let slice_len = bitmask_data.len() / batch_size;
@@ -975,12 +966,14 @@ fn test_batch_fill_next_token_bitmask_pressure_shuffled() {
     shuffled_indices.reverse(); // Deterministic shuffle
 
     let mut batch_matcher = BatchGrammarMatcher::new(2).unwrap();
-    batch_matcher.batch_fill_next_token_bitmask(
-        &matchers,
-        &mut tensor,
-        Some(&shuffled_indices),
-        false,
-    );
+    batch_matcher
+        .batch_fill_next_token_bitmask(
+            &matchers,
+            &mut tensor,
+            Some(&shuffled_indices),
+            false,
+        )
+        .unwrap();
 
     for i in 0..matchers.len() {
         let output_idx = shuffled_indices[i] as usize;
@@ -1000,3 +993,349 @@ fn test_batch_fill_next_token_bitmask_pressure_shuffled() {
         );
     }
 }
+
+#[test]
+#[serial]
+fn test_fork_n() {
+    let json_grammar = Grammar::builtin_json_grammar();
+    let mut matcher = matcher_from_grammar(&json_grammar);
+    assert!(matcher.accept_string("{\"name\"", false));
+
+    let mut branches = matcher.fork_n(4);
+    assert_eq!(branches.len(), 4);
+
+    // Each branch continues independently from the forked state.
+    let continuations = [": \"a\"}", ": true}", ": null}", ": [1, 2]}"];
+    for (branch, continuation) in branches.iter_mut().zip(continuations) {
+        assert!(branch.accept_string(continuation, false));
+        assert!(branch.is_terminated());
+    }
+
+    // The original matcher is unaffected by its branches.
+    assert!(!matcher.is_terminated());
+    assert!(matcher.accept_string(": false}", false));
+    assert!(matcher.is_terminated());
+}
+
+#[test]
+#[serial]
+fn test_batch_matcher_pipeline() {
+    let vocab = ["a", "b", "c"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        xgrammar::GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let mut matchers: Vec<xgrammar::GrammarMatcher> = ["ab", "cb"]
+        .iter()
+        .map(|s| {
+            let grammar =
+                Grammar::from_ebnf(&format!("root ::= \"{s}\""), "root")
+                    .unwrap();
+            let compiled = compiler.compile_grammar(&grammar).unwrap();
+            xgrammar::GrammarMatcher::new(&compiled, None, true, -1).unwrap()
+        })
+        .collect();
+
+    let mut pipeline = xgrammar::BatchMatcherPipeline::new(2).unwrap();
+
+    let vocab_size = vocab.len();
+    let mut bitmask = xgrammar::allocate_token_bitmask(2, vocab_size);
+    let (mut tensor, _shape, _strides) =
+        create_bitmask_dltensor(&mut bitmask, 2, vocab_size);
+
+    // Accept "a" on the first matcher and "c" on the second, then fill the
+    // next-token bitmask in the background. The returned step guard borrows
+    // the matchers and the tensor until `wait` releases them.
+    let step = pipeline
+        .submit(&mut matchers, &[0, 2], &mut tensor, None, false)
+        .unwrap();
+    let oks = step.wait().unwrap();
+    assert_eq!(&*oks, &[true, true]);
+
+    // Both grammars expect "b" next.
+    let (_, words_per_row) = xgrammar::get_bitmask_shape(2, vocab_size);
+    for row in 0..2 {
+        let row_words =
+            &bitmask[row * words_per_row..(row + 1) * words_per_row];
+        assert!(!is_token_accepted_helper(0, row_words));
+        assert!(is_token_accepted_helper(1, row_words));
+        assert!(!is_token_accepted_helper(2, row_words));
+    }
+
+    // The pipeline is reusable after wait(). Dropping the step guard without
+    // waiting blocks until the step finishes, so the borrows are released
+    // only once the background thread is done with them.
+    let step = pipeline
+        .submit(&mut matchers, &[1, 1], &mut tensor, None, false)
+        .unwrap();
+    drop(step);
+    assert!(matchers.iter().all(|m| m.is_terminated()));
+}
+
+#[test]
+#[serial]
+fn test_matcher_stats() {
+    let vocab = ["a", "b", "c"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let grammar = Grammar::from_ebnf("root ::= \"ab\"", "root").unwrap();
+    let mut matcher = matcher_from_grammar_with_tokenizer_and_rollback(
+        &grammar,
+        &tokenizer_info,
+        4,
+    );
+    assert_eq!(matcher.stats(), xgrammar::MatcherStats::default());
+
+    let vocab_size = vocab.len();
+    let mut bitmask_data = xgrammar::allocate_token_bitmask(1, vocab_size);
+    let (mut tensor, _shape, _strides) =
+        create_bitmask_dltensor(&mut bitmask_data, 1, vocab_size);
+    matcher.fill_next_token_bitmask(&mut tensor, 0, false);
+
+    assert!(matcher.accept_token(0)); // "a"
+    assert!(!matcher.accept_token(2)); // "c" is rejected
+    matcher.rollback(1);
+    assert!(matcher.accept_token(0));
+
+    let stats = matcher.stats();
+    assert_eq!(stats.fill_bitmask_calls, 1);
+    assert_eq!(stats.tokens_accepted, 2);
+    assert_eq!(stats.tokens_rejected, 1);
+    assert_eq!(stats.rollback_calls, 1);
+    assert_eq!(stats.rollback_tokens, 1);
+
+    // Forked matchers start with fresh counters.
+    assert_eq!(matcher.fork().stats(), xgrammar::MatcherStats::default());
+
+    // Aggregation sums every counter.
+    let mut total = xgrammar::MatcherStats::default();
+    total.merge(&stats);
+    total.merge(&stats);
+    assert_eq!(total.tokens_accepted, 4);
+    assert_eq!(total.fill_bitmask_calls, 2);
+    assert_eq!(total.fill_bitmask_ns, stats.fill_bitmask_ns * 2);
+
+    matcher.reset_stats();
+    assert_eq!(matcher.stats(), xgrammar::MatcherStats::default());
+}
+
+#[test]
+#[serial]
+fn test_batch_find_jump_forward_string() {
+    let vocab = ["a", "b", "c"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        xgrammar::GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let mut matcher_for = |ebnf: &str| {
+        let grammar = Grammar::from_ebnf(ebnf, "root").unwrap();
+        let compiled = compiler.compile_grammar(&grammar).unwrap();
+        xgrammar::GrammarMatcher::new(&compiled, None, true, -1).unwrap()
+    };
+    let matchers = vec![
+        matcher_for("root ::= \"ab\""),
+        matcher_for("root ::= \"a\" | \"b\""),
+        matcher_for("root ::= \"cba\""),
+    ];
+
+    // The fully forced grammars jump forward to their whole string; the
+    // alternation is ambiguous from the start and yields nothing.
+    let mut out = xgrammar::JumpForwardStrings::new();
+    xgrammar::BatchGrammarMatcher::batch_find_jump_forward_string(
+        &matchers, None, -1, &mut out,
+    )
+    .unwrap();
+    assert_eq!(out.len(), 3);
+    assert_eq!(out.get(0), Some(&b"ab"[..]));
+    assert_eq!(out.get(1), Some(&b""[..]));
+    assert_eq!(out.get(2), Some(&b"cba"[..]));
+    assert_eq!(out.get(3), None);
+    let collected: Vec<&[u8]> = out.iter().collect();
+    assert_eq!(collected, vec![&b"ab"[..], &b""[..], &b"cba"[..]]);
+
+    // An indexed subset is written in indices order, reusing the buffer.
+    xgrammar::BatchGrammarMatcher::batch_find_jump_forward_string(
+        &matchers,
+        Some(&[2, 0]),
+        1,
+        &mut out,
+    )
+    .unwrap();
+    assert_eq!(out.len(), 2);
+    assert_eq!(out.get(0), Some(&b"cba"[..]));
+    assert_eq!(out.get(1), Some(&b"ab"[..]));
+
+    // Out-of-range indices are rejected up front, not indexed.
+    for bad_indices in [&[3][..], &[-1][..], &[0, 3][..]] {
+        assert!(
+            xgrammar::BatchGrammarMatcher::batch_find_jump_forward_string(
+                &matchers,
+                Some(bad_indices),
+                1,
+                &mut out,
+            )
+            .is_err()
+        );
+    }
+}
+
+#[test]
+#[serial]
+fn test_batch_make_grammar_matchers() {
+    let vocab = ["a", "b", "c"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let grammar = Grammar::from_ebnf("root ::= \"ab\"", "root").unwrap();
+    let mut compiler =
+        xgrammar::GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let compiled = compiler.compile_grammar(&grammar).unwrap();
+
+    let mut matchers =
+        xgrammar::GrammarMatcher::new_batch(&compiled, None, true, -1, 4, 2)
+            .unwrap();
+    assert_eq!(matchers.len(), 4);
+
+    // Each matcher has independent state.
+    assert!(matchers[0].accept_token(0)); // "a"
+    assert!(matchers[0].accept_token(1)); // "b"
+    assert!(matchers[0].is_completed());
+    assert!(!matchers[1].accept_token(1)); // "b" rejected at the start
+    assert!(matchers[1].accept_token(0));
+    assert!(!matchers[1].is_completed());
+
+    // The single-threaded path and an empty batch are valid too.
+    let more =
+        xgrammar::GrammarMatcher::new_batch(&compiled, None, true, -1, 2, 1)
+            .unwrap();
+    assert_eq!(more.len(), 2);
+    assert!(
+        xgrammar::GrammarMatcher::new_batch(&compiled, None, true, -1, 0, -1)
+            .unwrap()
+            .is_empty()
+    );
+}
+
+#[test]
+#[serial]
+fn test_matcher_pool() {
+    let vocab = ["a", "b", "c"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        xgrammar::GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let grammar_ab = Grammar::from_ebnf("root ::= \"ab\"", "root").unwrap();
+    let grammar_c = Grammar::from_ebnf("root ::= \"c\"", "root").unwrap();
+    let compiled_ab = compiler.compile_grammar(&grammar_ab).unwrap();
+    let compiled_c = compiler.compile_grammar(&grammar_c).unwrap();
+
+    let mut pool = xgrammar::MatcherPool::new(true, -1, 2);
+    assert_eq!(pool.idle_count(1), 0);
+
+    // Miss constructs; check-in resets and parks under the key.
+    let mut matcher = pool.checkout(1, &compiled_ab).unwrap();
+    assert!(matcher.accept_token(0)); // "a"
+    pool.checkin(1, matcher);
+    assert_eq!(pool.idle_count(1), 1);
+
+    // Reuse starts from the initial state again.
+    let mut reused = pool.checkout(1, &compiled_ab).unwrap();
+    assert_eq!(pool.idle_count(1), 0);
+    assert!(reused.accept_token(0));
+    assert!(reused.accept_token(1));
+    assert!(reused.is_completed());
+    pool.checkin(1, reused);
+
+    // Keys keep grammars apart; the per-key idle cap drops the overflow.
+    let mut matcher_c = pool.checkout(2, &compiled_c).unwrap();
+    assert!(!matcher_c.accept_token(0));
+    assert!(matcher_c.accept_token(2));
+    pool.checkin(2, matcher_c);
+    assert_eq!(pool.idle_count(1), 1);
+    assert_eq!(pool.idle_count(2), 1);
+    for _ in 0..3 {
+        let m = pool.checkout(1, &compiled_ab).unwrap();
+        pool.checkin(1, m);
+        let extra = pool.checkout(3, &compiled_ab).unwrap();
+        pool.checkin(3, extra);
+    }
+    assert!(pool.idle_count(3) <= 2);
+
+    pool.clear();
+    assert_eq!(pool.idle_count(1), 0);
+    assert_eq!(pool.idle_count(2), 0);
+}
+
+#[test]
+#[serial]
+fn test_checkpoint_restore() {
+    let vocab = vec![
+        "<s>",
+        "</s>",
+        "a",
+        "abc",
+        "b\"",
+        "\"",
+        ":\"",
+        "{",
+        "}",
+        ", ",
+        "6",
+        ":",
+        "\n",
+        " ",
+        "\"a\":true",
+    ];
+    let id = |t: &str| vocab.iter().position(|v| *v == t).unwrap() as i32;
+
+    let json_grammar = Grammar::builtin_json_grammar();
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    // No rollback window needed: checkpoints replace per-token history.
+    let mut matcher = matcher_from_grammar_with_tokenizer_and_rollback(
+        &json_grammar,
+        &tokenizer_info,
+        0,
+    );
+
+    assert!(matcher.accept_token(id("{")));
+    assert!(matcher.accept_token(id("\"")));
+    let bitmask_at_branch =
+        get_next_token_bitmask_helper(&mut matcher, vocab.len());
+    let branch_point = matcher.checkpoint();
+
+    // First beam: advance several tokens, then restore without consuming
+    // the checkpoint.
+    for t in ["abc", "b\"", ":", "6"] {
+        assert!(matcher.accept_token(id(t)));
+    }
+    matcher.restore(&branch_point);
+    let bitmask_after =
+        get_next_token_bitmask_helper(&mut matcher, vocab.len());
+    assert_eq!(bitmask_at_branch, bitmask_after);
+
+    // Second beam from the same checkpoint.
+    for t in ["abc", "\"", ":", "6"] {
+        assert!(matcher.accept_token(id(t)));
+    }
+    matcher.restore(&branch_point);
+    assert_eq!(
+        bitmask_at_branch,
+        get_next_token_bitmask_helper(&mut matcher, vocab.len())
+    );
+
+    // Final restore consumes the checkpoint, then decoding continues to a
+    // terminated state.
+    for t in ["abc", "b\"", ":", "6"] {
+        assert!(matcher.accept_token(id(t)));
+    }
+    matcher.restore_owned(branch_point);
+    assert_eq!(
+        bitmask_at_branch,
+        get_next_token_bitmask_helper(&mut matcher, vocab.len())
+    );
+    for t in ["abc", "b\"", ":", "6", "}"] {
+        assert!(matcher.accept_token(id(t)));
+    }
+    assert!(matcher.accept_token(id("</s>")));
+    assert!(matcher.is_terminated());
+}
@@ -232,3 +232,36 @@ fn test_regression_lookahead_already_completed() {
     assert!(matcher.accept_string("123", false));
     assert!(matcher.is_terminated());
 }
+
+#[test]
+#[serial]
+fn test_compile_regex_set() {
+    let vocab = ["a", "b", "c", "d", "0", "1"];
+    let tok = xgrammar::TokenizerInfo::new(
+        &vocab,
+        xgrammar::VocabType::RAW,
+        &None,
+        false,
+    )
+    .unwrap();
+    let mut compiler =
+        xgrammar::GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+
+    // Duplicated pattern exercises the dedup path.
+    let compiled =
+        compiler.compile_regex_set(&[r"a+", r"b+c", r"\d+", r"a+"]).unwrap();
+
+    for (input, expected) in
+        [("aaa", true), ("bbc", true), ("10", true), ("ca", false), ("", false)]
+    {
+        let mut matcher =
+            xgrammar::GrammarMatcher::new(&compiled, None, true, -1).unwrap();
+        let accepted =
+            matcher.accept_string(input, false) && matcher.is_terminated();
+        assert_eq!(accepted, expected, "input: {input:?}");
+    }
+
+    let no_patterns: [&str; 0] = [];
+    assert!(compiler.compile_regex_set(&no_patterns).is_err());
+    assert!(compiler.compile_regex_set(&[r"a+", r"a{3,2}"]).is_err());
+}
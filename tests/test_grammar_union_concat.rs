@@ -194,3 +194,28 @@ root_2 ::= (([a-z] root_2) | ([a-z]))
     assert!(concat_str.contains("root_1 ::= ((triggered_tags))"));
     assert!(concat_str.contains("root_2 ::= (([a-z] root_2) | ([a-z]))"));
 }
+
+#[test]
+#[serial]
+fn test_grammar_union_deduped() {
+    let make_true =
+        || Grammar::from_ebnf(r#"root ::= "true""#, "root").unwrap();
+    let make_false =
+        || Grammar::from_ebnf(r#"root ::= "false""#, "root").unwrap();
+
+    // Duplicates collapse to the first occurrence of each distinct grammar.
+    let deduped = Grammar::union_deduped(&[
+        make_true(),
+        make_false(),
+        make_true(),
+        make_true(),
+        make_false(),
+    ]);
+    let expected = Grammar::union(&[make_true(), make_false()]);
+    assert_eq!(deduped.to_string(), expected.to_string());
+
+    // A catalog of one distinct grammar unions only one input.
+    let deduped = Grammar::union_deduped(&[make_true(), make_true()]);
+    let expected = Grammar::union(&[make_true()]);
+    assert_eq!(deduped.to_string(), expected.to_string());
+}
@@ -320,3 +320,250 @@ fn test_serialize_grammar_utf8() {
     assert!(is_grammar_accept_string(&grammar, test_str));
     assert!(is_grammar_accept_string(&deserialized, test_str));
 }
+
+#[test]
+#[serial]
+fn test_serialize_bytes_tokenizer_info_roundtrip() {
+    let orig = construct_tokenizer_info();
+    let bytes = orig.serialize_bytes();
+    let recovered =
+        TokenizerInfo::deserialize_bytes(&bytes).expect("deserialize bytes");
+    assert_eq!(orig.vocab_size(), recovered.vocab_size());
+    assert_eq!(&*orig.stop_token_ids(), &*recovered.stop_token_ids());
+}
+
+#[test]
+#[serial]
+fn test_serialize_bytes_compiled_grammar_roundtrip() {
+    let (orig_cg, tok) = construct_compiled_grammar();
+    let bytes = orig_cg.serialize_bytes();
+    let recovered = CompiledGrammar::deserialize_bytes(&bytes, &tok)
+        .expect("deserialize bytes");
+    assert_eq!(orig_cg.serialize_json(), recovered.serialize_json());
+}
+
+#[test]
+#[serial]
+fn test_serialize_bytes_errors() {
+    let (cg, tok) = construct_compiled_grammar();
+    let bytes = cg.serialize_bytes();
+
+    // Bad magic.
+    let mut corrupted = bytes.clone();
+    corrupted[0] = b'Z';
+    assert!(CompiledGrammar::deserialize_bytes(&corrupted, &tok).is_err());
+
+    // Truncated container.
+    assert!(CompiledGrammar::deserialize_bytes(&bytes[..8], &tok).is_err());
+
+    // Wrong payload kind: a tokenizer container fed to the compiled-grammar
+    // deserializer.
+    let tok_bytes = tok.serialize_bytes();
+    assert!(CompiledGrammar::deserialize_bytes(&tok_bytes, &tok).is_err());
+    assert!(TokenizerInfo::deserialize_bytes(&bytes).is_err());
+}
+
+#[test]
+#[serial]
+fn test_tokenizer_registry_shared() {
+    TokenizerInfo::registry_clear();
+    assert_eq!(TokenizerInfo::registry_size(), 0);
+
+    // Identical construction inputs converge on one registry entry.
+    let vocab = ["1", "212", "a", "A", "b", "一", "-", "aBc", "abc"];
+    let stop_ids: Option<Box<[i32]>> = Some(Box::new([0, 1]));
+    let first = TokenizerInfo::new_shared(
+        &vocab,
+        VocabType::BYTE_FALLBACK,
+        Some(10),
+        &stop_ids,
+        true,
+    )
+    .unwrap();
+    let second = TokenizerInfo::new_shared(
+        &vocab,
+        VocabType::BYTE_FALLBACK,
+        Some(10),
+        &stop_ids,
+        true,
+    )
+    .unwrap();
+    assert_eq!(TokenizerInfo::registry_size(), 1);
+    assert_eq!(first.vocab_size(), second.vocab_size());
+
+    // Different inputs get their own entry.
+    let other = TokenizerInfo::new_shared(
+        &vocab,
+        VocabType::BYTE_FALLBACK,
+        Some(11),
+        &stop_ids,
+        true,
+    )
+    .unwrap();
+    assert_eq!(TokenizerInfo::registry_size(), 2);
+    assert_eq!(other.vocab_size(), 11);
+
+    // Deserialization entry points share through the registry as well.
+    let json = first.serialize_json();
+    let a = TokenizerInfo::deserialize_json_shared(&json).unwrap();
+    let b = TokenizerInfo::deserialize_json_shared(&json).unwrap();
+    assert_eq!(TokenizerInfo::registry_size(), 3);
+    assert_eq!(a.vocab_size(), b.vocab_size());
+
+    let bytes = first.serialize_bytes();
+    let c = TokenizerInfo::deserialize_bytes_shared(&bytes).unwrap();
+    assert_eq!(c.vocab_size(), first.vocab_size());
+
+    // Clearing releases the registry's references; existing handles stay
+    // usable.
+    TokenizerInfo::registry_clear();
+    assert_eq!(TokenizerInfo::registry_size(), 0);
+    assert_eq!(first.vocab_size(), 10);
+}
+
+#[test]
+#[serial]
+fn test_matcher_snapshot_roundtrip() {
+    let vocab = ["a", "b", "c"];
+    let tokenizer_info =
+        TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler =
+        GrammarCompiler::new(&tokenizer_info, 1, false, -1).unwrap();
+    let grammar = Grammar::from_ebnf("root ::= \"abc\"", "root").unwrap();
+    let compiled = compiler.compile_grammar(&grammar).unwrap();
+
+    let mut matcher =
+        xgrammar::GrammarMatcher::new(&compiled, None, true, -1).unwrap();
+    assert!(matcher.accept_token(0)); // "a"
+    assert!(matcher.accept_token(1)); // "b"
+
+    let snapshot = matcher.snapshot(42).unwrap();
+    assert_eq!(snapshot.grammar_key(), 42);
+    assert_eq!(snapshot.token_ids(), &[0, 1]);
+
+    // The binary container round-trips losslessly.
+    let bytes = snapshot.to_bytes();
+    let decoded = xgrammar::MatcherSnapshot::from_bytes(&bytes).unwrap();
+    assert_eq!(decoded, snapshot);
+    assert!(xgrammar::MatcherSnapshot::from_bytes(b"junk").is_err());
+
+    // A corrupted token-count prefix (the last length field in the
+    // payload) must yield `Err`, not a multi-gigabyte allocation.
+    let mut corrupted = bytes.clone();
+    let count_at = corrupted.len() - snapshot.token_ids().len() * 4 - 4;
+    corrupted[count_at..count_at + 4].copy_from_slice(&u32::MAX.to_le_bytes());
+    assert!(xgrammar::MatcherSnapshot::from_bytes(&corrupted).is_err());
+
+    // The restored matcher continues exactly where the original stopped.
+    let mut restored =
+        xgrammar::GrammarMatcher::from_snapshot(&compiled, &decoded).unwrap();
+    assert!(!restored.is_completed());
+    assert!(restored.accept_token(2)); // "c"
+    assert!(restored.is_completed());
+    // And can itself be snapshotted again.
+    assert_eq!(restored.snapshot(42).unwrap().token_ids(), &[0, 1, 2]);
+
+    // Restoring against a different grammar is detected during replay.
+    let other_grammar = Grammar::from_ebnf("root ::= \"c\"", "root").unwrap();
+    let other_compiled = compiler.compile_grammar(&other_grammar).unwrap();
+    let err =
+        xgrammar::GrammarMatcher::from_snapshot(&other_compiled, &decoded)
+            .unwrap_err();
+    assert!(err.contains("replay"), "unexpected error: {err}");
+
+    // String acceptance leaves no token history to replay; reset re-arms
+    // snapshotting, and rollback keeps the history in sync.
+    assert!(matcher.accept_string("c", false));
+    assert!(matcher.snapshot(42).is_err());
+    matcher.reset();
+    assert!(matcher.accept_token(0));
+    assert!(matcher.accept_token(1));
+    matcher.rollback(1);
+    assert_eq!(matcher.snapshot(42).unwrap().token_ids(), &[0]);
+}
+
+#[test]
+#[serial]
+fn test_grammar_bundle_roundtrip() {
+    let tok = construct_tokenizer_info();
+    let mut compiler = GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+    let cg_a = compiler
+        .compile_grammar(
+            &Grammar::from_ebnf(r#"root ::= "a""#, "root").unwrap(),
+        )
+        .unwrap();
+    let cg_b = compiler
+        .compile_grammar(
+            &Grammar::from_ebnf(r#"root ::= "b""#, "root").unwrap(),
+        )
+        .unwrap();
+
+    let mut builder = xgrammar::GrammarBundleBuilder::new();
+    builder.add(1, &cg_a).add(2, &cg_b);
+    assert_eq!(builder.len(), 2);
+
+    // Insertion order must not change the archive bytes.
+    let mut reordered = xgrammar::GrammarBundleBuilder::new();
+    reordered.add(2, &cg_b).add(1, &cg_a);
+    assert_eq!(builder.to_bytes(), reordered.to_bytes());
+
+    let mut bundle =
+        xgrammar::GrammarBundle::from_bytes(builder.to_bytes()).unwrap();
+    assert_eq!(bundle.len(), 2);
+    assert!(bundle.contains(1));
+    assert!(!bundle.contains(3));
+    assert_eq!(bundle.materialized_count(), 0);
+
+    // Entries materialize lazily and only once.
+    let restored = bundle.get(1, &tok).unwrap().expect("entry 1");
+    let mut matcher =
+        xgrammar::GrammarMatcher::new(restored, None, true, -1).unwrap();
+    assert!(matcher.accept_string("a", false));
+    assert_eq!(bundle.materialized_count(), 1);
+    bundle.get(1, &tok).unwrap().expect("entry 1 again");
+    assert_eq!(bundle.materialized_count(), 1);
+    assert!(bundle.get(3, &tok).unwrap().is_none());
+    assert_eq!(bundle.materialized_count(), 1);
+
+    // Deserialization errors surface on access, not on open.
+    let other_tok = TokenizerInfo::new_with_vocab_size(
+        &["x", "y"],
+        VocabType::RAW,
+        Some(2),
+        &None,
+        false,
+    )
+    .unwrap();
+    assert!(bundle.get(2, &other_tok).is_err());
+}
+
+#[test]
+#[serial]
+fn test_grammar_bundle_file_and_errors() {
+    let tok = construct_tokenizer_info();
+    let mut compiler = GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+    let cg = compiler
+        .compile_grammar(
+            &Grammar::from_ebnf(r#"root ::= "a""#, "root").unwrap(),
+        )
+        .unwrap();
+
+    let path = std::env::temp_dir()
+        .join(format!("xgrammar-bundle-test-{}.bin", std::process::id()));
+    let mut builder = xgrammar::GrammarBundleBuilder::new();
+    builder.add(7, &cg);
+    builder.write_to(&path).unwrap();
+
+    let mut bundle = xgrammar::GrammarBundle::open(&path).unwrap();
+    assert!(bundle.get(7, &tok).unwrap().is_some());
+    std::fs::remove_file(&path).unwrap();
+
+    assert!(xgrammar::GrammarBundle::open(&path).is_err());
+    assert!(xgrammar::GrammarBundle::from_bytes(b"junk".to_vec()).is_err());
+    // A container of the wrong payload kind is rejected from the header.
+    assert!(xgrammar::GrammarBundle::from_bytes(cg.serialize_bytes()).is_err());
+    // A truncated index is rejected on open.
+    let mut truncated = builder.to_bytes();
+    truncated.truncate(truncated.len() - 40);
+    assert!(xgrammar::GrammarBundle::from_bytes(truncated).is_err());
+}
@@ -182,3 +182,88 @@ fn test_traverse_draft_tree_shape_assertion() {
         .is_err()
     );
 }
+
+#[test]
+#[serial]
+fn test_batch_traverse_draft_tree() {
+    let grammar = Grammar::builtin_json_grammar();
+    let vocab =
+        ["a", "b", "c", "{", "}", "\"", ":", ",", " ", "true", "false", "null"];
+    let tok = TokenizerInfo::new(&vocab, VocabType::RAW, &None, false).unwrap();
+    let mut compiler = GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+    let compiled_grammar = compiler.compile_grammar(&grammar).unwrap();
+    let matchers: Vec<GrammarMatcher> =
+        GrammarMatcher::new_batch(&compiled_grammar, None, true, -1, 2, 1)
+            .unwrap();
+
+    let num_nodes = 3usize;
+    let mut rt_data_0: Vec<i64> = vec![1, 2, -1];
+    let mut rs_data_0: Vec<i64> = vec![-1, -1, -1];
+    let mut dt_data_0: Vec<i64> = vec![3, 6, 4]; // {, :, }
+    let mut rt_data_1: Vec<i64> = vec![1, -1, -1];
+    let mut rs_data_1: Vec<i64> = vec![-1, 2, -1];
+    let mut dt_data_1: Vec<i64> = vec![3, 5, 4]; // {, ", }
+
+    let (rt_0, _s0, _t0) = create_i64_1d_dltensor(&mut rt_data_0);
+    let (rs_0, _s1, _t1) = create_i64_1d_dltensor(&mut rs_data_0);
+    let (dt_0, _s2, _t2) = create_i64_1d_dltensor(&mut dt_data_0);
+    let (rt_1, _s3, _t3) = create_i64_1d_dltensor(&mut rt_data_1);
+    let (rs_1, _s4, _t4) = create_i64_1d_dltensor(&mut rs_data_1);
+    let (dt_1, _s5, _t5) = create_i64_1d_dltensor(&mut dt_data_1);
+
+    let vocab_size = vocab.len();
+    let mut bitmask_data_0 = allocate_token_bitmask(num_nodes, vocab_size);
+    let mut bitmask_data_1 = allocate_token_bitmask(num_nodes, vocab_size);
+    let (mut bm_0, _bs0, _bt0) =
+        create_bitmask_dltensor(&mut bitmask_data_0, num_nodes, vocab_size);
+    let (mut bm_1, _bs1, _bt1) =
+        create_bitmask_dltensor(&mut bitmask_data_1, num_nodes, vocab_size);
+
+    let completed = xgrammar::BatchGrammarMatcher::batch_traverse_draft_tree(
+        &matchers,
+        &[&rt_0, &rt_1],
+        &[&rs_0, &rs_1],
+        &[&dt_0, &dt_1],
+        &mut [&mut bm_0, &mut bm_1],
+        -1.0,
+        2,
+    )
+    .unwrap();
+    assert_eq!(&*completed, &[true, true]);
+
+    // Both sequences start JSON parsing, so both root bitmasks reject tokens.
+    for bm in [&bm_0, &bm_1] {
+        let rejected =
+            testing::get_masked_tokens_from_bitmask(bm, vocab_size as i32, 0);
+        assert!(!rejected.is_empty());
+    }
+
+    // A spent time budget yields per-sequence fallback flags, not errors.
+    let completed = xgrammar::BatchGrammarMatcher::batch_traverse_draft_tree(
+        &matchers,
+        &[&rt_0, &rt_1],
+        &[&rs_0, &rs_1],
+        &[&dt_0, &dt_1],
+        &mut [&mut bm_0, &mut bm_1],
+        1e-12,
+        1,
+    )
+    .unwrap();
+    assert_eq!(&*completed, &[false, false]);
+
+    // Invalid tensors are still reported as errors.
+    let mut rs_wrong_shape: Vec<i64> = vec![-1, -1];
+    let (rs_bad, _sb, _tb) = create_i64_1d_dltensor(&mut rs_wrong_shape);
+    assert!(
+        xgrammar::BatchGrammarMatcher::batch_traverse_draft_tree(
+            &matchers,
+            &[&rt_0, &rt_1],
+            &[&rs_bad, &rs_1],
+            &[&dt_0, &dt_1],
+            &mut [&mut bm_0, &mut bm_1],
+            -1.0,
+            1,
+        )
+        .is_err()
+    );
+}
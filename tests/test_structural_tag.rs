@@ -62,3 +62,54 @@ fn test_empty_tag_dispatch_accepts_any() {
     assert!(m.accept_string("any string", false));
     assert!(m.is_terminated());
 }
+
+#[test]
+#[serial]
+fn test_structural_tag_cache_order_independent() {
+    let schema1 = r#"{"type":"object","properties":{"arg1":{"type":"string"}},"required":["arg1"]}"#;
+    let schema2 = r#"{"type":"object","properties":{"arg2":{"type":"integer"}},"required":["arg2"]}"#;
+    let tag_f = StructuralTagItem::new("<function=f", schema1, "</function>");
+    let tag_g = StructuralTagItem::new("<function=g", schema2, "</function>");
+    let triggers = vec!["<function=f", "<function=g"];
+
+    let tok = xgrammar::TokenizerInfo::new(
+        &[""],
+        xgrammar::VocabType::RAW,
+        &None,
+        false,
+    )
+    .unwrap();
+    let mut compiler =
+        xgrammar::GrammarCompiler::new(&tok, 1, false, -1).unwrap();
+    assert_eq!(compiler.structural_tag_cache_hits(), 0);
+
+    let both = compiler
+        .compile_structural_tag(&[tag_f.clone(), tag_g.clone()], &triggers)
+        .unwrap();
+    assert_eq!(compiler.structural_tag_cache_hits(), 0);
+
+    // The same tag set in a different order is served from the cache.
+    let swapped = compiler
+        .compile_structural_tag(&[tag_g.clone(), tag_f.clone()], &triggers)
+        .unwrap();
+    assert_eq!(compiler.structural_tag_cache_hits(), 1);
+    assert_eq!(both.serialize_json(), swapped.serialize_json());
+
+    // Toggling one tool off is a different subset and compiles fresh...
+    let only_f =
+        compiler.compile_structural_tag(&[tag_f.clone()], &triggers).unwrap();
+    assert_eq!(compiler.structural_tag_cache_hits(), 1);
+    assert_ne!(both.serialize_json(), only_f.serialize_json());
+
+    // ...but toggling it back on hits the cached full set again.
+    let _ = compiler
+        .compile_structural_tag(&[tag_f.clone(), tag_g.clone()], &triggers)
+        .unwrap();
+    assert_eq!(compiler.structural_tag_cache_hits(), 2);
+
+    // Different triggers are a different key.
+    let _ = compiler
+        .compile_structural_tag(&[tag_f, tag_g], &["<function=f"])
+        .unwrap();
+    assert_eq!(compiler.structural_tag_cache_hits(), 2);
+}
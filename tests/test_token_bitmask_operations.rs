@@ -332,6 +332,75 @@ fn test_apply_token_bitmask_inplace_cpu_vocab_size() {
     }
 }
 
+fn create_u16_1d_dltensor(
+    data: &mut [u16],
+    code: xgrammar::DLDataTypeCode,
+) -> (xgrammar::CxxUniquePtr<xgrammar::DLTensor>, Vec<i64>, Vec<i64>) {
+    let mut shape = vec![data.len() as i64];
+    let mut strides = vec![1i64];
+    let tensor = unsafe {
+        xgrammar::DLTensor::new(
+            data.as_mut_ptr() as *mut xgrammar::c_void,
+            xgrammar::DLDevice {
+                device_type: xgrammar::DLDeviceType::kDLCPU,
+                device_id: 0,
+            },
+            1,
+            xgrammar::DLDataType {
+                code: code as u8,
+                bits: 16,
+                lanes: 1,
+            },
+            shape.as_mut_ptr(),
+            strides.as_mut_ptr(),
+            0,
+        )
+    };
+    (tensor, shape, strides)
+}
+
+#[test]
+#[serial]
+fn test_apply_token_bitmask_inplace_cpu_f16_bf16() {
+    // -inf bit patterns for IEEE binary16 and bfloat16.
+    let cases = [
+        (xgrammar::DLDataTypeCode::kDLFloat, 0xFC00u16),
+        (xgrammar::DLDataTypeCode::kDLBfloat, 0xFF80u16),
+    ];
+    let vocab_size = 70usize;
+    let one_bits = 0x3C00u16; // placeholder "live" logit bits
+    let bool_mask: Vec<bool> = (0..vocab_size).map(|i| i % 3 != 0).collect();
+    let mut bitmask_data = pack_bool_masks_to_bitmask_data(
+        std::slice::from_ref(&bool_mask),
+        vocab_size,
+    );
+
+    for (code, neg_inf_bits) in cases {
+        let (bitmask_tensor, _bshape, _bstrides) =
+            create_bitmask_dltensor(&mut bitmask_data, 1, vocab_size);
+        let mut logits = vec![one_bits; vocab_size];
+        let (mut logits_tensor, _lshape, _lstrides) =
+            create_u16_1d_dltensor(&mut logits, code.clone());
+
+        apply_token_bitmask_inplace_cpu(
+            &mut logits_tensor,
+            &bitmask_tensor,
+            Some(vocab_size as i32),
+            None,
+        )
+        .unwrap();
+
+        for i in 0..vocab_size {
+            let expected = if bool_mask[i] {
+                one_bits
+            } else {
+                neg_inf_bits
+            };
+            assert_eq!(logits[i], expected, "code={code:?}, i={i}");
+        }
+    }
+}
+
 #[test]
 #[serial]
 fn test_apply_token_bitmask_inplace_cpu_indices_mismatch() {
@@ -386,3 +455,122 @@ fn test_apply_token_bitmask_inplace_cpu_indices_mismatch() {
         }
     }
 }
+
+#[test]
+#[serial]
+fn test_apply_token_bitmask_inplace_device_dispatch() {
+    use xgrammar::{
+        DLDataType, DLDataTypeCode, DLDevice, DLDeviceType, DLTensor,
+        apply_token_bitmask_inplace, c_void,
+    };
+
+    // CPU logits go through the same path as the `_cpu` entry point.
+    let vocab_size = 10usize;
+    let bool_mask: Vec<bool> = (0..vocab_size).map(|i| i % 2 == 1).collect();
+    let mut bitmask_data = pack_bool_masks_to_bitmask_data(
+        std::slice::from_ref(&bool_mask),
+        vocab_size,
+    );
+    let (bitmask_tensor, _bshape, _bstrides) =
+        create_bitmask_dltensor(&mut bitmask_data, 1, vocab_size);
+
+    let mut logits: Vec<f32> = (1..=vocab_size).map(|x| x as f32).collect();
+    let (mut logits_tensor, _lshape, _lstrides) =
+        create_f32_1d_dltensor(&mut logits);
+
+    apply_token_bitmask_inplace(
+        &mut logits_tensor,
+        &bitmask_tensor,
+        Some(vocab_size as i32),
+        None,
+    )
+    .unwrap();
+
+    for i in 0..vocab_size {
+        let expected = if bool_mask[i] {
+            (i + 1) as f32
+        } else {
+            f32::NEG_INFINITY
+        };
+        assert_eq!(logits[i], expected, "i={i}");
+    }
+
+    // Logits on an unsupported device are rejected before any data access;
+    // the tensor below points at host memory but claims to be on CUDA.
+    let mut shape = vec![vocab_size as i64];
+    let mut strides = vec![1i64];
+    let mut cuda_logits_tensor = unsafe {
+        DLTensor::new(
+            logits.as_mut_ptr() as *mut c_void,
+            DLDevice {
+                device_type: DLDeviceType::kDLCUDA,
+                device_id: 0,
+            },
+            1,
+            DLDataType {
+                code: DLDataTypeCode::kDLFloat as u8,
+                bits: 32,
+                lanes: 1,
+            },
+            shape.as_mut_ptr(),
+            strides.as_mut_ptr(),
+            0,
+        )
+    };
+    let err = apply_token_bitmask_inplace(
+        &mut cuda_logits_tensor,
+        &bitmask_tensor,
+        Some(vocab_size as i32),
+        None,
+    )
+    .unwrap_err();
+    assert!(err.contains("device"), "unexpected error: {err}");
+}
+
+#[test]
+#[serial]
+fn test_bitmask_merge_ops() {
+    let mut grammar_mask = vec![0b1111i32, 0b0011];
+    let allow = vec![0b1010i32, 0b1111];
+    xgrammar::bitmask_and_inplace(&mut grammar_mask, &allow);
+    assert_eq!(grammar_mask, vec![0b1010, 0b0011]);
+
+    let extra = vec![0b0001i32, 0b0100];
+    xgrammar::bitmask_or_inplace(&mut grammar_mask, &extra);
+    assert_eq!(grammar_mask, vec![0b1011, 0b0111]);
+
+    // Ban list: set bits mark banned tokens.
+    let banned = vec![0b0010i32, 0b0111];
+    xgrammar::bitmask_andnot_inplace(&mut grammar_mask, &banned);
+    assert_eq!(grammar_mask, vec![0b1001, 0b0000]);
+}
+
+#[test]
+#[serial]
+fn test_bitmask_count_and_search() {
+    let vocab_size = 40usize;
+    let mut mask = allocate_token_bitmask(1, vocab_size);
+    // Freshly allocated masks allow everything; bits beyond the vocab are
+    // ignored.
+    assert_eq!(xgrammar::bitmask_count_allowed(&mask, vocab_size), vocab_size);
+
+    mask.fill(0);
+    assert_eq!(xgrammar::bitmask_count_allowed(&mask, vocab_size), 0);
+    assert_eq!(xgrammar::bitmask_first_allowed(&mask, vocab_size), None);
+
+    mask[0] = 1 << 5;
+    mask[1] = (1 << 1) | (1 << 7);
+    assert_eq!(xgrammar::bitmask_count_allowed(&mask, vocab_size), 3);
+    assert_eq!(xgrammar::bitmask_first_allowed(&mask, vocab_size), Some(5));
+    assert_eq!(xgrammar::bitmask_next_allowed(&mask, vocab_size, 6), Some(33));
+    assert_eq!(xgrammar::bitmask_next_allowed(&mask, vocab_size, 34), Some(39));
+    assert_eq!(xgrammar::bitmask_next_allowed(&mask, vocab_size, 40), None);
+    assert_eq!(
+        xgrammar::bitmask_iter_allowed(&mask, vocab_size).collect::<Vec<_>>(),
+        vec![5, 33, 39]
+    );
+
+    // A single-token state is the forced-token signal.
+    mask[1] = 0;
+    assert_eq!(xgrammar::bitmask_count_allowed(&mask, vocab_size), 1);
+}